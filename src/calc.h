@@ -26,6 +26,7 @@
 #include <cmath>
 #include <algorithm>
 #include "global.h"
+#include "simd.h"
 
 /**
  * convenience utilities to process values
@@ -65,6 +66,34 @@ namespace Calc {
         return ( semitones > 0.f ) ? pow( 1.05946f, semitones ) : pow( 0.94387f, -semitones );
     }
 
+    /**
+     * approximates the tangent of given angle (in radians, within the 0 - PI range) as
+     * the ratio of the Taylor polynomials of its sine and cosine (to the 11th and 12th degree)
+     * the relative error remains below 2e-6 up to 1.5 radians (e.g. the angle of a filter whose
+     * cutoff is at 0.48 times the sample rate), which is considerably cheaper than tan()
+     * Vector is either float or SIMD::float4 (approximating the tangent of each lane)
+     */
+    template <typename Vector>
+    inline Vector fastTan( Vector x )
+    {
+        // the polynomials are evaluated in the 0 - PI / 2 range, mirroring the angle beyond
+        const float PI = 3.141592653589793f;
+
+        auto mirrored = SIMD::greaterThan( x, Vector( PI / 2.f ));
+        x = SIMD::select( mirrored, Vector( PI ) - x, x );
+        Vector sign = SIMD::select( mirrored, Vector( -1.f ), Vector( 1.f ));
+
+        Vector x2 = x * x;
+
+        Vector sine = x * ( Vector( 1.f ) + x2 * ( Vector( -1.f / 6.f ) + x2 * ( Vector( 1.f / 120.f ) + x2 * ( Vector( -1.f / 5040.f ) +
+                      x2 * ( Vector( 1.f / 362880.f ) + x2 * Vector( -1.f / 39916800.f ))))));
+
+        Vector cosine = Vector( 1.f ) + x2 * ( Vector( -1.f / 2.f ) + x2 * ( Vector( 1.f / 24.f ) + x2 * ( Vector( -1.f / 720.f ) +
+                        x2 * ( Vector( 1.f / 40320.f ) + x2 * ( Vector( -1.f / 3628800.f ) + x2 * Vector( 1.f / 479001600.f ))))));
+
+        return sign * sine / cosine;
+    }
+
     // inverts a 0 - 1 normalized min-to-max value to have 0 be the max and 1 the min
 
     inline float inverseNormalize( float value )
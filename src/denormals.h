@@ -0,0 +1,135 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __DENORMALS_HEADER__
+#define __DENORMALS_HEADER__
+
+#include "simd.h"
+#include <cstdint>
+
+#if defined( VSTSID_SIMD_SSE )
+#include <xmmintrin.h>
+#endif
+
+namespace Igorski {
+
+    /**
+     * Subnormal (denormal) numbers are the values too close to zero to be represented with full precision.
+     * Arithmetic on these is many times slower on most x86 processors, while the feedback of the recursive
+     * processes (e.g. the filter and ring modulator) decays into this range once their input falls silent,
+     * causing CPU spikes in otherwise idle instances.
+     *
+     * A DenormalGuard enables flush-to-zero (subnormal results are written as zero) and denormals-are-zero
+     * (subnormal operands are read as zero) for the calling thread during its lifetime, restoring the previous
+     * floating point mode of the thread upon destruction (the mode belongs to the host, which might rely on it)
+     */
+    class DenormalGuard {
+
+        public:
+#if defined( VSTSID_SIMD_SSE )
+
+            DenormalGuard() : previousMode( _mm_getcsr()) {
+                _mm_setcsr( previousMode | FLUSH_TO_ZERO | DENORMALS_ARE_ZERO );
+            }
+            ~DenormalGuard() {
+                _mm_setcsr( previousMode );
+            }
+
+        private:
+            static const uint32_t FLUSH_TO_ZERO      = 0x8000;
+            static const uint32_t DENORMALS_ARE_ZERO = 0x0040;
+
+            uint32_t previousMode;
+
+#elif defined( __aarch64__ ) && defined( __GNUC__ )
+
+            // ARMv8 has no separate denormals-are-zero mode, its flush-to-zero mode applies to both
+
+            DenormalGuard() {
+                __asm__ __volatile__( "mrs %0, fpcr" : "=r"( previousMode ));
+                __asm__ __volatile__( "msr fpcr, %0" : : "r"( previousMode | FLUSH_TO_ZERO ));
+            }
+            ~DenormalGuard() {
+                __asm__ __volatile__( "msr fpcr, %0" : : "r"( previousMode ));
+            }
+
+        private:
+            static const uint64_t FLUSH_TO_ZERO = 1 << 24;
+
+            uint64_t previousMode;
+
+#elif defined( __arm__ ) && defined( __GNUC__ ) && defined( __ARM_FP )
+
+            // NEON always flushes, this covers the scalar VFP instructions
+
+            DenormalGuard() {
+                __asm__ __volatile__( "vmrs %0, fpscr" : "=r"( previousMode ));
+                __asm__ __volatile__( "vmsr fpscr, %0" : : "r"( previousMode | FLUSH_TO_ZERO ));
+            }
+            ~DenormalGuard() {
+                __asm__ __volatile__( "vmsr fpscr, %0" : : "r"( previousMode ));
+            }
+
+        private:
+            static const uint32_t FLUSH_TO_ZERO = 1 << 24;
+
+            uint32_t previousMode;
+#else
+            // no means to control the floating point mode, rely on Denormals::flush() below
+            DenormalGuard() {}
+#endif
+            DenormalGuard( const DenormalGuard& ) = delete;
+            DenormalGuard& operator=( const DenormalGuard& ) = delete;
+    };
+
+    namespace Denormals {
+
+        // level (-300 dB) below which the state of the recursive processes is flushed to zero. This lies well
+        // above the subnormal range, so that the state (flushed once per rendered segment) does not decay
+        // into it before the next flush, even on platforms where the DenormalGuard has no effect
+
+        static const float FLUSH_THRESHOLD = 1e-15f;
+
+        // returns given value, or zero when its magnitude lies below the flush threshold
+        // (Vector is either SIMD::float4 or float, in which case the lanes are flushed individually)
+
+        template <typename Vector>
+        inline Vector flush( Vector value ) {
+            return SIMD::mask( value, SIMD::greaterThan( SIMD::abs( value ), Vector( FLUSH_THRESHOLD )));
+        }
+
+        // as above, adding the amount of non-zero values (or lanes) that were flushed to given counter
+
+        template <typename Vector>
+        inline Vector flush( Vector value, int& flushed ) {
+            Vector magnitude = SIMD::abs( value );
+            auto retained    = SIMD::greaterThan( magnitude, Vector( FLUSH_THRESHOLD ));
+
+            flushed += ( int ) SIMD::sum( SIMD::mask( Vector( 1.f ), SIMD::greaterThan( magnitude, Vector( 0.f ))) -
+                                          SIMD::mask( Vector( 1.f ), retained ));
+
+            return SIMD::mask( value, retained );
+        }
+    }
+}
+
+#endif
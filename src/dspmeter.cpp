@@ -0,0 +1,101 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "dspmeter.h"
+#include <algorithm>
+
+namespace Igorski {
+
+DSPLoadMeter::DSPLoadMeter()
+{
+    init( 44100.f, 512 );
+}
+
+DSPLoadMeter::~DSPLoadMeter()
+{
+
+}
+
+void DSPLoadMeter::init( float sampleRate, int maxSamplesPerBlock, float reportInterval )
+{
+    deadline              = ( std::max( 1, maxSamplesPerBlock ) / ( double ) sampleRate ) * 1e9;
+    reportIntervalSamples = ( int ) ( reportInterval * sampleRate );
+    blockStart            = 0;
+    stageStart            = 0;
+    reportedVoices        = 0;
+    reportedFlushes       = 0;
+
+    for ( int i = 0; i < STAGE_AMOUNT; ++i ) {
+        blockTime[ i ] = 0;
+        report[ i ]    = { 0.f, 0.f, 0.f };
+    }
+    resetWindow();
+}
+
+bool DSPLoadMeter::endBlock( int numSamples, int activeVoices, int flushedValues )
+{
+    blockTime[ TOTAL ] = now() - blockStart;
+
+    for ( int i = 0; i < STAGE_AMOUNT; ++i )
+    {
+        float load = ( float ) ( 100.0 * blockTime[ i ] / deadline );
+        StageLoad& stage = window[ i ];
+
+        stage.min      = windowBlocks == 0 ? load : std::min( stage.min, load );
+        stage.max      = std::max( stage.max, load );
+        stage.average += load; // divided upon report
+    }
+    windowVoices  = std::max( windowVoices, activeVoices );
+    windowFlushes = std::max( windowFlushes, flushedValues );
+    windowSamples += numSamples;
+    ++windowBlocks;
+
+    if ( windowSamples < reportIntervalSamples ) {
+        return false;
+    }
+
+    for ( int i = 0; i < STAGE_AMOUNT; ++i ) {
+        report[ i ] = window[ i ];
+        report[ i ].average /= windowBlocks;
+    }
+    reportedVoices  = windowVoices;
+    reportedFlushes = windowFlushes;
+
+    resetWindow();
+
+    return true;
+}
+
+/* private methods */
+
+void DSPLoadMeter::resetWindow()
+{
+    for ( int i = 0; i < STAGE_AMOUNT; ++i ) {
+        window[ i ] = { 0.f, 0.f, 0.f };
+    }
+    windowBlocks  = 0;
+    windowSamples = 0;
+    windowVoices  = 0;
+    windowFlushes = 0;
+}
+
+} // E.O. namespace Igorski
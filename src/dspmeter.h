@@ -0,0 +1,123 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __DSPLOADMETER_HEADER__
+#define __DSPLOADMETER_HEADER__
+
+#include <chrono>
+#include <cstdint>
+
+namespace Igorski {
+
+    /**
+     * Measures the time spent in the individual DSP stages of the process call
+     * Stage timings are accumulated per block and expressed as a percentage of the
+     * block deadline (e.g. the duration of the largest block the host will request).
+     * Over each report interval the minimum, average and maximum load per stage is
+     * aggregated, so these can be published at a lower rate than the block rate
+     */
+    class DSPLoadMeter {
+
+        public:
+            enum Stages {
+                SYNTHESIS = 0,
+                FILTER,
+                RING_MODULATOR,
+                TOTAL,
+                STAGE_AMOUNT
+            };
+
+            // load per stage, in percentage of the block deadline
+
+            struct StageLoad {
+                float min;
+                float average;
+                float max;
+            };
+
+            DSPLoadMeter();
+            ~DSPLoadMeter();
+
+            void init( float sampleRate, int maxSamplesPerBlock, float reportInterval = 0.1f );
+
+            inline int64_t now() const
+            {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()
+                ).count();
+            }
+
+            // invoke at the start of the process call (starts the TOTAL stage)
+            inline void startBlock()
+            {
+                blockStart = now();
+                for ( int i = 0; i < STAGE_AMOUNT; ++i ) {
+                    blockTime[ i ] = 0;
+                }
+            }
+
+            inline void startStage()
+            {
+                stageStart = now();
+            }
+
+            // stages can be entered multiple times per block, their times are accumulated
+            inline void endStage( Stages stage )
+            {
+                blockTime[ stage ] += now() - stageStart;
+            }
+
+            // invoke at the end of the process call, returns true when
+            // the report interval has elapsed and a new report is available
+            // flushedValues is the amount of state values flushed to zero (see Denormals::flush()) during the block
+
+            bool endBlock( int numSamples, int activeVoices, int flushedValues = 0 );
+
+            const StageLoad& getLoad( Stages stage ) const { return report[ stage ]; }
+            int getActiveVoices() const { return reportedVoices; }
+            int getFlushedValues() const { return reportedFlushes; } // peak amount per block
+
+        private:
+            double deadline;         // in nanoseconds
+            int reportIntervalSamples;
+
+            int64_t blockStart;
+            int64_t stageStart;
+            int64_t blockTime[ STAGE_AMOUNT ];
+
+            // aggregation of the current report window
+
+            StageLoad window[ STAGE_AMOUNT ];
+            int windowBlocks;
+            int windowSamples;
+            int windowVoices;
+            int windowFlushes;
+
+            StageLoad report[ STAGE_AMOUNT ];
+            int reportedVoices;
+            int reportedFlushes;
+
+            void resetWindow();
+    };
+}
+
+#endif
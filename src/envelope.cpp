@@ -0,0 +1,134 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "envelope.h"
+#include <math.h>
+
+namespace Igorski {
+namespace Envelope {
+
+// amount of samples it takes to cover given distance at given (positive) increment per sample
+
+inline int getSteps( float distance, float increment, bool inclusive )
+{
+    if ( increment <= 0.f ) {
+        return INDEFINITE;
+    }
+    double steps = inclusive ? floor( distance / increment ) + 1.0 : ceil( distance / increment );
+
+    if ( steps >= ( double ) INDEFINITE ) {
+        return INDEFINITE;
+    }
+    return steps < 1.0 ? 1 : ( int ) steps;
+}
+
+Ramp getRamp( const Note::ADSR& adsr, bool released )
+{
+    Ramp ramp;
+
+    // release cancels all other phases (e.g. early noteOff before other phases have completed)
+    // its envelope is defined for as long as the released level remains positive
+
+    if ( adsr.release > 0.f && released ) {
+        float level = adsr.sustain - adsr.releaseValue;
+
+        if ( level < 0.f ) {
+            ramp.stage     = Stages::COMPLETE;
+            ramp.value     = 0.f;
+            ramp.increment = 0.f;
+            ramp.length    = INDEFINITE;
+        } else {
+            ramp.stage     = Stages::RELEASE;
+            ramp.value     = level;
+            ramp.increment = -adsr.releaseIncrement;
+            ramp.length    = getSteps( level, adsr.releaseIncrement, true );
+        }
+        return ramp;
+    }
+
+    // attack phase rises from the current value up until the attack level
+
+    if ( adsr.attack > 0.f && adsr.attackValue < adsr.attack ) {
+        ramp.stage     = Stages::ATTACK;
+        ramp.value     = adsr.attackValue;
+        ramp.increment = adsr.attackIncrement;
+        ramp.length    = getSteps( adsr.attack - adsr.attackValue, adsr.attackIncrement, false );
+
+        return ramp;
+    }
+
+    // decay phase descends from the current envelope for as long as it exceeds the sustain level
+
+    if ( adsr.decay > 0.f && adsr.sustain != 1.f && adsr.envelope > adsr.sustain ) {
+        ramp.stage     = Stages::DECAY;
+        ramp.value     = adsr.envelope - adsr.decayIncrement;
+        ramp.increment = -adsr.decayIncrement;
+        ramp.length    = getSteps( adsr.envelope - adsr.sustain, adsr.decayIncrement, false );
+
+        return ramp;
+    }
+
+    // sustain phase
+
+    ramp.stage     = Stages::SUSTAIN;
+    ramp.value     = adsr.sustain;
+    ramp.increment = 0.f;
+    ramp.length    = INDEFINITE;
+
+    return ramp;
+}
+
+void advance( Note::ADSR& adsr, Ramp& ramp, bool released, int samples )
+{
+    // the envelope holds the last written gain of the attack and decay phases
+
+    float last = ramp.value + ramp.increment * ( float ) ( samples - 1 );
+
+    switch ( ramp.stage )
+    {
+        case Stages::ATTACK:
+            adsr.envelope    = last;
+            adsr.attackValue = ramp.value + ramp.increment * ( float ) samples;
+            break;
+
+        case Stages::DECAY:
+            adsr.envelope = last;
+            break;
+
+        case Stages::RELEASE:
+            adsr.releaseValue += adsr.releaseIncrement * ( float ) samples;
+            break;
+
+        default:
+            return; // sustain and completed stages are constant
+    }
+
+    if ( samples < ramp.length ) {
+        ramp.value  += ramp.increment * ( float ) samples;
+        ramp.length -= samples;
+    } else {
+        ramp = getRamp( adsr, released );
+    }
+}
+
+} // E.O. namespace Envelope
+} // E.O. namespace Igorski
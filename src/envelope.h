@@ -0,0 +1,65 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __ENVELOPE_HEADER__
+#define __ENVELOPE_HEADER__
+
+#include "note.h"
+
+namespace Igorski {
+
+    /**
+     * Evaluates the ADSR envelope of a Note as a sequence of linear ramps. Rather than
+     * determining the stage of the envelope for every sample, the amount of samples
+     * remaining in the current stage is calculated upfront, so gains can be written
+     * in blocks and stage transitions only occur at the ramp boundaries
+     */
+    namespace Envelope {
+
+        enum Stages {
+            ATTACK,
+            DECAY,
+            SUSTAIN,
+            RELEASE,
+            COMPLETE // release has completed, the Note can be disposed
+        };
+
+        // ramp length of the stages that last until the Note is released
+        const int INDEFINITE = 0x7FFFFFFF;
+
+        struct Ramp {
+            int stage;
+            float value;     // gain of the next sample
+            float increment; // change in gain per sample
+            int length;      // amount of samples until the next stage
+        };
+
+        // retrieve the ramp for the current stage of given envelope
+        Ramp getRamp( const Note::ADSR& adsr, bool released );
+
+        // advance given envelope by given amount of samples (at most the length of
+        // the ramp), updating the ramp when moving onto the next stage
+        void advance( Note::ADSR& adsr, Ramp& ramp, bool released, int samples );
+    }
+}
+
+#endif
@@ -22,13 +22,14 @@
  */
 #include "filter.h"
 #include "global.h"
+#include "calc.h"
 #include <algorithm>
 
 using namespace Steinberg;
 
 namespace Igorski {
 
-Filter::Filter( float sampleRate ) {
+Filter::Filter( float sampleRate ) : _svf( sampleRate ), _groupFilter( sampleRate ), _voiceFilter( sampleRate ) {
 
     _sampleRate = sampleRate;
     _cutoff     = VST::FILTER_MIN_FREQ;
@@ -38,7 +39,13 @@ Filter::Filter( float sampleRate ) {
     _lfoMax     = VST::FILTER_MAX_FREQ;
     _lfoRange   = _cutoff * _depth;
     _tempCutoff = _cutoff; // used when applying LFO
-    
+
+    _targetCutoff    = _cutoff;
+    _targetResonance = _resonance;
+    _cutoffStep      = 0.f;
+    _resonanceStep   = 0.f;
+    _rampSamples     = 0;
+
     _a1 = 0.f;
     _a2 = 0.f;
     _a3 = 0.f;
@@ -49,39 +56,32 @@ Filter::Filter( float sampleRate ) {
     _lfo = new Igorski::LFO( sampleRate );
 
     _hasLFO = false;
+    _mode   = FilterModes::BIQUAD_LOW_PASS;
 
-    // stereo (2) probably enough...
-    int numChannels = 8;
+    _envelopeDepth = 0.f;
 
-    _in1  = new float[ numChannels ];
-    _in2  = new float[ numChannels ];
-    _out1 = new float[ numChannels ];
-    _out2 = new float[ numChannels ];
+    _in1  = 0.f;
+    _in2  = 0.f;
+    _out1 = 0.f;
+    _out2 = 0.f;
+
+    _flushedValues = 0;
 
-    for ( int i = 0; i < numChannels; ++i )
-    {
-        _in1 [ i ] = 0.f;
-        _in2 [ i ] = 0.f;
-        _out1[ i ] = 0.f;
-        _out2[ i ] = 0.f;
-    }
     setCutoff( VST::FILTER_MAX_FREQ / 2 );
 }
 
 Filter::~Filter() {
     delete _lfo;
-    delete[] _in1;
-    delete[] _in2;
-    delete[] _out1;
-    delete[] _out2;
 }
 
 /* public methods */
 
 void Filter::updateProperties( float cutoffPercentage, float resonancePercentage, float LFORatePercentage, float LFODepth )
 {
-    float co  = VST::FILTER_MIN_FREQ + ( cutoffPercentage * ( VST::FILTER_MAX_FREQ - VST::FILTER_MIN_FREQ ));
-    float res = VST::FILTER_MIN_RESONANCE + ( resonancePercentage * ( VST::FILTER_MAX_RESONANCE - VST::FILTER_MIN_RESONANCE ));
+    float co  = scaleCutoff( cutoffPercentage );
+    float res = scaleResonance( resonancePercentage );
+
+    completeRamp();
 
     if ( _cutoff != co || _resonance != res ) {
         setCutoff( co );
@@ -104,15 +104,55 @@ void Filter::updateProperties( float cutoffPercentage, float resonancePercentage
     }
 }
 
+void Filter::rampProperties( float cutoffPercentage, float resonancePercentage, int samples )
+{
+    float co  = std::max( VST::FILTER_MIN_FREQ, std::min( scaleCutoff( cutoffPercentage ), VST::FILTER_MAX_FREQ ));
+    float res = std::max( VST::FILTER_MIN_RESONANCE, std::min( scaleResonance( resonancePercentage ), VST::FILTER_MAX_RESONANCE ));
+
+    completeRamp();
+
+    if ( samples <= 0 ) {
+        setCutoff( co );
+        setResonance( res );
+        return;
+    }
+    _targetCutoff    = co;
+    _targetResonance = res;
+    _cutoffStep      = ( co - _cutoff ) / ( float ) samples;
+    _resonanceStep   = ( res - _resonance ) / ( float ) samples;
+    _rampSamples     = ( co != _cutoff || res != _resonance ) ? samples : 0;
+}
+
+void Filter::completeRamp()
+{
+    if ( _rampSamples == 0 ) {
+        return;
+    }
+    _rampSamples = 0;
+    _resonance   = _targetResonance;
+
+    // the LFO sweeps relative to the cutoff (see setCutoff())
+
+    float tempRatio = _tempCutoff / _cutoff;
+    _cutoff     = _targetCutoff;
+    _tempCutoff = _cutoff * tempRatio;
+
+    cacheLFOProperties();
+    calculateParameters();
+}
+
 void Filter::setCutoff( float frequency )
 {
+    completeRamp();
+
     // in case LFO is moving, set the current temp cutoff (last LFO value)
     // to the relative value for the new cutoff frequency)
 
     float tempRatio = _tempCutoff / _cutoff;
 
-    _cutoff     = std::max( VST::FILTER_MIN_FREQ, std::min( frequency, VST::FILTER_MAX_FREQ ));
-    _tempCutoff = _cutoff * tempRatio;
+    _cutoff       = std::max( VST::FILTER_MIN_FREQ, std::min( frequency, VST::FILTER_MAX_FREQ ));
+    _tempCutoff   = _cutoff * tempRatio;
+    _targetCutoff = _cutoff;
 
     calculateParameters();
 }
@@ -124,7 +164,11 @@ float Filter::getCutoff()
 
 void Filter::setResonance( float resonance )
 {
-    _resonance = std::max( VST::FILTER_MIN_RESONANCE, std::min( resonance, VST::FILTER_MAX_RESONANCE ));
+    completeRamp();
+
+    _resonance       = std::max( VST::FILTER_MIN_RESONANCE, std::min( resonance, VST::FILTER_MAX_RESONANCE ));
+    _targetResonance = _resonance;
+
     calculateParameters();
 }
 
@@ -147,9 +191,101 @@ void Filter::setLFO( bool enabled )
     }
 }
 
+void Filter::setMode( int mode )
+{
+    if ( mode == _mode ) {
+        return;
+    }
+    _mode = mode;
+
+    // the history of the previous response does not apply to the new response
+
+    reset();
+    calculateParameters();
+}
+
+int Filter::getMode()
+{
+    return _mode;
+}
+
+bool Filter::hasTail()
+{
+    if ( _mode != FilterModes::BIQUAD_LOW_PASS ) {
+        return _svf.hasTail();
+    }
+    return ( fabs( _in1 ) + fabs( _in2 ) + fabs( _out1 ) + fabs( _out2 )) > VST::SILENCE_THRESHOLD;
+}
+
+void Filter::reset()
+{
+    _in1  = 0.f;
+    _in2  = 0.f;
+    _out1 = 0.f;
+    _out2 = 0.f;
+
+    _svf.reset();
+}
+
+int Filter::getTailSamples()
+{
+    // the response decays the slowest at the lowest cutoff frequency the LFO can sweep to
+    // (the responses of the state variable filter share the poles of the biquad)
+
+    float cutoff = _hasLFO ? std::min( _lfoMin, _tempCutoff ) : _tempCutoff;
+
+    double c  = 1.0 / tan( 3.141592653589793 * cutoff / _sampleRate );
+    double a1 = 1.0 / ( 1.0 + _resonance * c + c * c );
+    double b1 = 2.0 * ( 1.0 - c * c ) * a1;
+    double b2 = ( 1.0 - _resonance * c + c * c ) * a1;
+
+    // each sample the response decays by the magnitude of the largest pole of the filter
+
+    double discriminant = b1 * b1 - 4.0 * b2;
+    double radius = ( discriminant < 0.0 ) ? sqrt( b2 ) : ( fabs( b1 ) + sqrt( discriminant )) / 2.0;
+
+    if ( radius <= 0.0 ) {
+        return 0;
+    }
+    // (capped for poles on the unit circle, which would never decay)
+    return ( int ) ceil( log( VST::SILENCE_THRESHOLD ) / log( std::min( radius, 0.99999 )));
+}
+
+int Filter::collectFlushedValues()
+{
+    int flushedValues = _flushedValues + _svf.collectFlushedValues() +
+                        _groupFilter.collectFlushedValues() + _voiceFilter.collectFlushedValues();
+    _flushedValues = 0;
+    return flushedValues;
+}
+
+void Filter::setEnvelopeDepth( float depth )
+{
+    _envelopeDepth = std::max( 0.f, std::min( depth, 1.f ));
+}
+
+void Filter::sweepVoices( int length )
+{
+    _voiceCutoffs[ 0 ]    = _tempCutoff;
+    _voiceResonances[ 0 ] = _resonance;
+
+    for ( int32 i = 0, period = 1; i < length; i += CONTROL_RATE, ++period )
+    {
+        if ( isModulated()) {
+            sweepCutoff( std::min( CONTROL_RATE, length - i ));
+        }
+        _voiceCutoffs[ period ]    = _tempCutoff;
+        _voiceResonances[ period ] = _resonance;
+    }
+}
+
 void Filter::calculateParameters()
 {
-    _c  = 1.f / tan( 3.141592653589793f * _tempCutoff / _sampleRate );
+    if ( _mode != FilterModes::BIQUAD_LOW_PASS ) {
+        _svf.setCoefficients( _tempCutoff, _resonance );
+        return;
+    }
+    _c  = 1.f / Calc::fastTan( 3.141592653589793f * _tempCutoff / _sampleRate );
     _a1 = 1.f / ( 1.f + _resonance * _c + _c * _c );
     _a2 = 2.f * _a1;
     _a3 = _a1;
@@ -157,6 +293,42 @@ void Filter::calculateParameters()
     _b2 = ( 1.f - _resonance * _c + _c * _c ) * _a1;
 }
 
+void Filter::sweepCutoff( int samples )
+{
+    if ( _rampSamples > 0 )
+    {
+        int rampSamples = std::min( samples, _rampSamples );
+        _rampSamples -= rampSamples;
+
+        // the end of the ramp is applied exactly, preventing accumulated rounding errors
+
+        _cutoff    = ( _rampSamples == 0 ) ? _targetCutoff    : _cutoff    + _cutoffStep    * rampSamples;
+        _resonance = ( _rampSamples == 0 ) ? _targetResonance : _resonance + _resonanceStep * rampSamples;
+
+        if ( _hasLFO ) {
+            cacheLFOProperties();
+        } else {
+            _tempCutoff = _cutoff;
+        }
+    }
+    if ( !_hasLFO ) {
+        return;
+    }
+    // multiply by .5 and add .5 to make bipolar waveform unipolar
+    float lfoValue = _lfo->peek( samples ) * .5f  + .5f;
+    _tempCutoff = fmin( _lfoMax, _lfoMin + _lfoRange * lfoValue );
+}
+
+float Filter::scaleCutoff( float cutoffPercentage )
+{
+    return VST::FILTER_MIN_FREQ + ( cutoffPercentage * ( VST::FILTER_MAX_FREQ - VST::FILTER_MIN_FREQ ));
+}
+
+float Filter::scaleResonance( float resonancePercentage )
+{
+    return VST::FILTER_MIN_RESONANCE + ( resonancePercentage * ( VST::FILTER_MAX_RESONANCE - VST::FILTER_MIN_RESONANCE ));
+}
+
 void Filter::cacheLFOProperties()
 {
     _lfoRange = _cutoff * _depth;
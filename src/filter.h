@@ -25,10 +25,22 @@
 
 #include "global.h"
 #include "lfo.h"
+#include "svfilter.h"
+#include "denormals.h"
 #include <math.h>
 
 namespace Igorski {
 
+    // the filter responses, either the low-pass biquad or one of the responses of the state variable filter
+
+    enum FilterModes
+    {
+        BIQUAD_LOW_PASS,
+        SVF_LOW_PASS,
+        SVF_BAND_PASS,
+        SVF_HIGH_PASS
+    };
+
     class Filter {
 
         public:
@@ -43,14 +55,59 @@ namespace Igorski {
             float getDepth();
             void setLFO( bool enabled );
 
+            // the response of the filter (see FilterModes), changing the mode resets the filter
+            void setMode( int mode );
+            int getMode();
+
             void calculateParameters();
+
+            // interval (in samples) at which the coefficients are calculated while the LFO
+            // is sweeping the cutoff, the coefficients are interpolated linearly in between
+            static constexpr int CONTROL_RATE = 32;
     
             // update Filter properties, the values here are in normalized 0 - 1 range
             void updateProperties( float cutoffPercentage, float resonancePercentage, float LFORatePercentage, float fLFODepth );
 
-            // apply filter to incoming sampleBuffer contents
-            template <typename SampleType>  
-            void process( SampleType** sampleBuffer, int amountOfChannels, int bufferSize );
+            // ramps the cutoff and resonance (in the same range as updateProperties()) linearly from their current values
+            // towards given values over the next given amount of processed samples (e.g. in between the points of their
+            // automation), during which the coefficients are calculated at control rate. completeRamp() applies the
+            // values at the end of the ramp immediately (setting the next ramp or any of the properties does the same)
+            void rampProperties( float cutoffPercentage, float resonancePercentage, int samples );
+            void completeRamp();
+
+            // apply filter to incoming (mono) sampleBuffer contents
+            template <typename SampleType>
+            void process( SampleType* sampleBuffer, int bufferSize );
+
+            // whether the filter is still ringing out previously processed input (e.g. its
+            // history has not decayed below VST::SILENCE_THRESHOLD), when not it can be reset()
+            bool hasTail();
+            void reset();
+
+            // the amount of samples it takes for the response of the filter to decay into silence
+            int getTailSamples();
+
+            // the amount of state values (of all responses and voices) flushed to zero as these were
+            // decaying towards the subnormal range, since the last invocation (after which the count restarts)
+            int collectFlushedValues();
+
+            // the filter can alternatively be applied to each voice individually (see Synthesizer::setVoiceFilter())
+            // in which case the cutoff of each voice follows the level of its envelope by given depth (in 0 - 1 range)
+            void setEnvelopeDepth( float depth );
+
+            // the maximum amount of samples filtered per voice at once
+            static constexpr int MAX_VOICE_SEGMENT_SIZE = 256;
+
+            // advances the LFO over the next segment of given length, calculating the swept
+            // cutoff of each of its control periods (shared by all voices filtered by processVoices())
+            void sweepVoices( int length );
+
+            // filters the current segment of either a full group of voices (Vector is SIMD::float4, each lane holding
+            // a voice) or a single voice (Vector is float) in place, using the state variable filter (where the biquad
+            // low-pass uses its low-pass response). The integrator states are owned by the voices, envelopes
+            // holds the envelope levels of the voices for each sample of the segment
+            template <typename Vector>
+            void processVoices( Vector* samples, int length, Vector& state1, Vector& state2, const Vector* envelopes );
     
         private:
             float _cutoff;
@@ -61,7 +118,38 @@ namespace Igorski {
             float _lfoMax;
             float _lfoRange;
             bool  _hasLFO;
+
+            // automation ramp of the cutoff and resonance (see rampProperties())
+
+            float _targetCutoff;
+            float _targetResonance;
+            float _cutoffStep;
+            float _resonanceStep;
+            int   _rampSamples;
             LFO*  _lfo;
+            int   _mode;
+
+            StateVariableFilter<float> _svf;
+
+            // per voice filtering
+
+            float _envelopeDepth;
+            float _voiceCutoffs[ MAX_VOICE_SEGMENT_SIZE / CONTROL_RATE + 1 ];
+            float _voiceResonances[ MAX_VOICE_SEGMENT_SIZE / CONTROL_RATE + 1 ];
+
+            StateVariableFilter<SIMD::float4> _groupFilter;
+            StateVariableFilter<float> _voiceFilter;
+
+            // the filter for either a group of voices or a single voice (selected by the type of the samples)
+            StateVariableFilter<SIMD::float4>& getVoiceFilter( SIMD::float4* /*samples*/ ) { return _groupFilter; }
+            StateVariableFilter<float>& getVoiceFilter( float* /*samples*/ ) { return _voiceFilter; }
+
+            // the cutoff of either a group of voices or a single voice at given envelope level
+            template <typename Vector>
+            inline Vector getVoiceCutoff( float cutoff, Vector envelope ) {
+                Vector voiceCutoff = Vector( cutoff ) * ( Vector( 1.f - _envelopeDepth ) + Vector( _envelopeDepth ) * envelope );
+                return SIMD::select( SIMD::lessThan( voiceCutoff, Vector( VST::FILTER_MIN_FREQ )), Vector( VST::FILTER_MIN_FREQ ), voiceCutoff );
+            }
 
             // used internally
 
@@ -73,12 +161,31 @@ namespace Igorski {
             float _b2;
             float _c;
 
-            float* _in1;
-            float* _in2;
-            float* _out1;
-            float* _out2;
+            float _in1;
+            float _in2;
+            float _out1;
+            float _out2;
+
+            int _flushedValues;
 
             void cacheLFOProperties();
+
+            // whether the cutoff is swept by the LFO or an automation ramp (in which case
+            // the coefficients are calculated at control rate)
+            inline bool isModulated() {
+                return _hasLFO || _rampSamples > 0;
+            }
+
+            // advances the LFO and the automation ramp by given amount of samples, updating the swept cutoff
+            void sweepCutoff( int samples );
+
+            // the cutoff frequency (in Hz) and resonance for given normalized values
+            float scaleCutoff( float cutoffPercentage );
+            float scaleResonance( float resonancePercentage );
+
+            // process() for the state variable filter in given SVFModes mode
+            template <int mode, typename SampleType>
+            void processStateVariable( SampleType* sampleBuffer, int bufferSize );
     };
 }
 
@@ -22,48 +22,162 @@
  */
 namespace Igorski {
 
-template <typename SampleType>  
-void Filter::process( SampleType** sampleBuffer, int amountOfChannels, int bufferSize )
+template <typename SampleType>
+void Filter::process( SampleType* sampleBuffer, int bufferSize )
 {
-    float initialLFOOffset = _hasLFO ? _lfo->getAccumulator() : 0.f;
-    float orgCutoff        = _tempCutoff;
+    switch ( _mode )
+    {
+        case FilterModes::SVF_LOW_PASS:
+            processStateVariable<SVFModes::LOW_PASS>( sampleBuffer, bufferSize );
+            return;
+
+        case FilterModes::SVF_BAND_PASS:
+            processStateVariable<SVFModes::BAND_PASS>( sampleBuffer, bufferSize );
+            return;
+
+        case FilterModes::SVF_HIGH_PASS:
+            processStateVariable<SVFModes::HIGH_PASS>( sampleBuffer, bufferSize );
+            return;
+    }
+
+    // local copies of the filter history and coefficients as the writes to sampleBuffer could otherwise alias the members
+
+    float in1  = _in1;
+    float in2  = _in2;
+    float out1 = _out1;
+    float out2 = _out2;
 
-    for ( int32 c = 0; c < amountOfChannels; ++c )
+    float a1 = _a1;
+    float a2 = _a2;
+    float a3 = _a3;
+    float b1 = _b1;
+    float b2 = _b2;
+
+    // without LFO (or automation ramp) the coefficients are constant and the buffer is processed as a single period
+
+    const bool modulated = isModulated();
+
+    for ( int32 i = 0; i < bufferSize; )
     {
-        // when processing each new channel restore to the same LFO offset to get the same movement ;)
-        if ( _hasLFO && c > 0 )
+        int32 periodEnd = bufferSize;
+
+        float a1Step = 0.f;
+        float b1Step = 0.f;
+        float b2Step = 0.f;
+
+        // oscillator attached to Filter ? travel the cutoff values between the minimum and
+        // maximum frequencies (the same applies to the automation ramp), the coefficients are
+        // calculated for the end of each control period, towards which the current coefficients are interpolated
+
+        if ( modulated )
         {
-            _lfo->setAccumulator( initialLFOOffset );
-            _tempCutoff = orgCutoff;
+            int32 periodLength = std::min( CONTROL_RATE, bufferSize - i );
+            periodEnd = i + periodLength;
+
+            sweepCutoff( periodLength );
             calculateParameters();
-        }
 
-        for ( int32 i = 0; i < bufferSize; ++i )
-        {
-            SampleType input  = sampleBuffer[ c ][ i ];
-            SampleType output = _a1 * input + _a2 * _in1[ c ] + _a3 * _in2[ c ] - _b1 * _out1[ c ] - _b2 * _out2[ c ];
+            float inversePeriodLength = 1.f / ( float ) periodLength;
 
-            _in2 [ c ] = _in1[ c ];
-            _in1 [ c ] = input;
-            _out2[ c ] = _out1[ c ];
-            _out1[ c ] = output;
+            a1Step = ( _a1 - a1 ) * inversePeriodLength;
+            b1Step = ( _b1 - b1 ) * inversePeriodLength;
+            b2Step = ( _b2 - b2 ) * inversePeriodLength;
+        }
 
-            // oscillator attached to Filter ? travel the cutoff values
-            // between the minimum and maximum frequencies
+        for ( ; i < periodEnd; ++i )
+        {
+            SampleType input  = sampleBuffer[ i ];
+            SampleType output = a1 * input + a2 * in1 + a3 * in2 - b1 * out1 - b2 * out2;
 
-            if ( _hasLFO )
-            {
-                // multiply by .5 and add .5 to make bipolar waveform unipolar
-                float lfoValue = _lfo->peek() * .5f  + .5f;
-                _tempCutoff = fmin( _lfoMax, _lfoMin + _lfoRange * lfoValue );
+            in2  = in1;
+            in1  = input;
+            out2 = out1;
+            out1 = output;
 
-                calculateParameters();
+            if ( modulated ) {
+                // a2 and a3 are multiples of a1
+                a1 += a1Step;
+                a2  = 2.f * a1;
+                a3  = a1;
+                b1 += b1Step;
+                b2 += b2Step;
             }
 
             // commit the effect
-            sampleBuffer[ c ][ i ] = output;
+            sampleBuffer[ i ] = output;
+        }
+
+        // prevent accumulating rounding errors
+
+        a1 = _a1;
+        a2 = _a2;
+        a3 = _a3;
+        b1 = _b1;
+        b2 = _b2;
+    }
+    // the feedback decays towards zero once the input falls silent, flush it before it becomes subnormal
+
+    _in1  = Denormals::flush( in1,  _flushedValues );
+    _in2  = Denormals::flush( in2,  _flushedValues );
+    _out1 = Denormals::flush( out1, _flushedValues );
+    _out2 = Denormals::flush( out2, _flushedValues );
+}
+
+template <typename Vector>
+void Filter::processVoices( Vector* samples, int length, Vector& state1, Vector& state2, const Vector* envelopes )
+{
+    StateVariableFilter<Vector>& filter = getVoiceFilter( samples );
+
+    // the coefficients start at the cutoff at the start of the segment, after which these are
+    // ramped towards the cutoff at the end of each control period (see sweepVoices())
+
+    filter.setState( state1, state2 );
+    filter.setCoefficients( getVoiceCutoff( _voiceCutoffs[ 0 ], envelopes[ 0 ]), _voiceResonances[ 0 ]);
+
+    for ( int32 i = 0, period = 1; i < length; i += CONTROL_RATE, ++period )
+    {
+        int32 periodLength = std::min( CONTROL_RATE, length - i );
+
+        filter.rampCoefficients( getVoiceCutoff( _voiceCutoffs[ period ], envelopes[ i + periodLength - 1 ]), _voiceResonances[ period ], periodLength );
+
+        switch ( _mode )
+        {
+            default:
+                filter.template process<SVFModes::LOW_PASS, true>( samples + i, periodLength );
+                break;
+
+            case FilterModes::SVF_BAND_PASS:
+                filter.template process<SVFModes::BAND_PASS, true>( samples + i, periodLength );
+                break;
+
+            case FilterModes::SVF_HIGH_PASS:
+                filter.template process<SVFModes::HIGH_PASS, true>( samples + i, periodLength );
+                break;
         }
     }
+    filter.getState( state1, state2 );
+}
+
+template <int mode, typename SampleType>
+void Filter::processStateVariable( SampleType* sampleBuffer, int bufferSize )
+{
+    if ( !isModulated()) {
+        _svf.process<mode, false>( sampleBuffer, bufferSize );
+        return;
+    }
+
+    // the state variable filter remains stable when its coefficients change each sample, its
+    // coefficients are calculated for the end of each control period and ramped towards in between
+
+    for ( int32 i = 0; i < bufferSize; i += CONTROL_RATE )
+    {
+        int32 periodLength = std::min( CONTROL_RATE, bufferSize - i );
+
+        sweepCutoff( periodLength );
+
+        _svf.rampCoefficients( _tempCutoff, _resonance, periodLength );
+        _svf.process<mode, true>( sampleBuffer + i, periodLength );
+    }
 }
 
 } // E.O. namespace Igorski
\ No newline at end of file
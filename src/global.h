@@ -27,6 +27,10 @@ namespace VST {
     static const float FILTER_MAX_RESONANCE = 0.7071067811865476f; //sqrt( 2.f ) / 2.f;
     static const float MAX_PITCH_BEND       = 12.f; // in semitones
 
+    // level (-100 dB) below which the decaying output is considered silent (e.g. the tail of the filter)
+
+    static const float SILENCE_THRESHOLD = .00001f;
+
     // maximum and minimum rate of oscillation in Hz
     // also see plugin.uidesc to update the controls to match
 
@@ -36,6 +40,40 @@ namespace VST {
     static const float MIN_RING_MOD_RATE() { return 0.f; }  // off
     static const float MAX_RING_MOD_RATE() { return 10000.0f; }
 
+    // upper bounds of the read-only meters published to the controller
+
+    static const float MAX_METERED_LOAD    = 100.f; // in percentage of the block deadline
+    static const int   MAX_METERED_VOICES  = 128;
+    static const int   MAX_METERED_FLUSHES = 4096; // in state values per block
+
+    // maximum amount of simultaneously playing Notes, as each pitch can only
+    // sound once this equals the MIDI note range (see VoicePool)
+
+    static const int MAX_POLYPHONY = 128;
+
+    // amount of policies to choose the Note to steal when the maximum amount of voices is playing (see VoiceStealing)
+
+    static const int VOICE_STEALING_POLICIES = 3;
+
+    // amount of filter responses (see FilterModes)
+
+    static const int FILTER_MODES = 4;
+
+    // in multi-timbral mode each MIDI channel plays its own part (see Part) with its own copy of the
+    // sound parameters (see PART_PARAMETERS). The first part uses the ids listed in paramids.h, the
+    // ids of the other parts are offset by PART_PARAMETER_OFFSET for each part
+
+    static const int MAX_PARTS             = 16;
+    static const int PART_PARAMETER_OFFSET = 100;
+
+    inline int getPartParameterId( int id, int part )    { return id + part * PART_PARAMETER_OFFSET; }
+    inline int getPart( int partParameterId )            { return partParameterId / PART_PARAMETER_OFFSET; }
+    inline int getBaseParameterId( int partParameterId ) { return partParameterId % PART_PARAMETER_OFFSET; }
+
+    // maximum amount of worker threads rendering the parts (alongside the audio thread, see WorkerPool)
+
+    static const int MAX_WORKERS = 7;
+
     // sine waveform used for the oscillator
     static const float TABLE[ 128 ] = { 0, 0.0490677, 0.0980171, 0.14673, 0.19509, 0.24298, 0.290285, 0.33689, 0.382683, 0.427555, 0.471397, 0.514103, 0.55557, 0.595699, 0.634393, 0.671559, 0.707107, 0.740951, 0.77301, 0.803208, 0.83147, 0.857729, 0.881921, 0.903989, 0.92388, 0.941544, 0.95694, 0.970031, 0.980785, 0.989177, 0.995185, 0.998795, 1, 0.998795, 0.995185, 0.989177, 0.980785, 0.970031, 0.95694, 0.941544, 0.92388, 0.903989, 0.881921, 0.857729, 0.83147, 0.803208, 0.77301, 0.740951, 0.707107, 0.671559, 0.634393, 0.595699, 0.55557, 0.514103, 0.471397, 0.427555, 0.382683, 0.33689, 0.290285, 0.24298, 0.19509, 0.14673, 0.0980171, 0.0490677, 1.22465e-16, -0.0490677, -0.0980171, -0.14673, -0.19509, -0.24298, -0.290285, -0.33689, -0.382683, -0.427555, -0.471397, -0.514103, -0.55557, -0.595699, -0.634393, -0.671559, -0.707107, -0.740951, -0.77301, -0.803208, -0.83147, -0.857729, -0.881921, -0.903989, -0.92388, -0.941544, -0.95694, -0.970031, -0.980785, -0.989177, -0.995185, -0.998795, -1, -0.998795, -0.995185, -0.989177, -0.980785, -0.970031, -0.95694, -0.941544, -0.92388, -0.903989, -0.881921, -0.857729, -0.83147, -0.803208, -0.77301, -0.740951, -0.707107, -0.671559, -0.634393, -0.595699, -0.55557, -0.514103, -0.471397, -0.427555, -0.382683, -0.33689, -0.290285, -0.24298, -0.19509, -0.14673, -0.0980171, -0.0490677 };
 
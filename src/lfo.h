@@ -24,6 +24,7 @@
 #define __LFO_H_INCLUDED__
 
 #include "global.h"
+#include <algorithm>
 
 namespace Igorski {
 class LFO {
@@ -61,6 +62,28 @@ class LFO {
             return VST::TABLE[ readOffset ];
         }
 
+        /**
+         * advance the accumulator by given amount of samples at once (e.g. when the
+         * LFO is read at control rate), retrieving the value for the last of these
+         * samples (as would be returned by the last of as many calls to peek())
+         */
+        inline float peek( int samples )
+        {
+            _accumulator += _rate * ( float ) ( samples - 1 );
+
+            while ( _accumulator >= VST::SAMPLE_RATE )
+                _accumulator -= VST::SAMPLE_RATE;
+
+            int readOffset = std::min( TABLE_SIZE - 1, ( int ) ( _accumulator / SR_OVER_LENGTH ));
+
+            _accumulator += _rate;
+
+            if ( _accumulator >= VST::SAMPLE_RATE )
+                _accumulator -= VST::SAMPLE_RATE;
+
+            return VST::TABLE[ readOffset ];
+        }
+
     private:
 
         // see Igorski::VST::LFO_TABLE;
@@ -0,0 +1,218 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __NOTE_HEADER__
+#define __NOTE_HEADER__
+
+#include "global.h"
+#include <string.h>
+
+using namespace Steinberg;
+
+namespace Igorski {
+
+    // fixed capacity list of pitches, as a pitch can only occur once the capacity
+    // equals the MIDI note range (no allocations occur when adding pitches)
+
+    struct PitchHistory {
+        static const int CAPACITY = 128;
+
+        int16 pitches[ CAPACITY ];
+        int size;
+
+        PitchHistory() : size( 0 ) {}
+
+        bool contains( int16 pitch ) const {
+            for ( int i = 0; i < size; ++i ) {
+                if ( pitches[ i ] == pitch ) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void add( int16 pitch ) {
+            if ( size < CAPACITY ) {
+                pitches[ size++ ] = pitch;
+            }
+        }
+
+        void remove( int16 pitch ) {
+            for ( int i = 0; i < size; ++i ) {
+                if ( pitches[ i ] == pitch ) {
+                    memmove( &pitches[ i ], &pitches[ i + 1 ], ( --size - i ) * sizeof( int16 ));
+                    return;
+                }
+            }
+        }
+
+        int16 last() const { return pitches[ size - 1 ]; }
+        void removeLast() { --size; }
+    };
+
+    struct Note;
+
+    // links a Note into an (intrusive) NoteList
+
+    struct NoteLink {
+        Note* previous;
+        Note* next;
+    };
+
+    // data type for a single Note, Notes are allocated from the VoicePool and
+    // aligned to cache lines so neighbouring voices do not share a line
+
+    struct alignas( 64 ) Note {
+        uint16 id;      // used internally to reference Notes
+        int16 pitch;    // provided by noteOn|Off events from host, used to map to playing Note
+        bool released;
+        bool stolen;    // whether the Note is fading out to make room for a new Note
+        uint32 order;   // sequence number of the noteOn
+        float volume;
+        float baseFrequency; // frequency (in Hz) at noteOn
+        float frequency;     // current render frequency (can be shifted by arpeggiator!)
+        float phase;
+        float pwm;
+        float filterState[ 2 ]; // integrator states when filtered per voice (see Filter::processVoices())
+
+        // arpeggio specific
+        int arpOffset;
+        int arpIndex;
+        float* arpFreqs;
+
+        struct PORTAMENTO {
+            bool enabled;
+            int steps;          // amount of samples over which portamento is executed
+            float increment;    // pitch increment in octaves (per step), gliding linearly in pitch
+            PitchHistory orgPitches; // history of pitches played before latest note was synthesizd
+
+            PORTAMENTO() {
+                enabled   = false;
+                steps     = 0;
+                increment = 0.f;
+            }
+        };
+        PORTAMENTO portamento;
+
+        struct ADSR {
+            float attack;
+            float decay;
+            float sustain;
+            float release;
+            float envelope;
+            int maxLength;
+
+            // the "_length"-properties describe the total length (in buffer cycles)
+            // the envelope lasts for
+            // the "_step"-properties describe the current offset in the total attack
+            // envelope slope (relative to total slope length "attack_length")
+
+            float attackDuration;
+            float attackValue;
+            float attackIncrement;
+
+            float decayDuration;
+            float decayValue;
+            float decayIncrement;
+
+            float releaseDuration;
+            float releaseValue;
+            float releaseIncrement;
+
+            // data type for a Note's ADSR properties
+            // ADSR is applied per Note, note for the entirety of the
+            // instrument as VSTSID is awesome
+
+            ADSR() {
+                attack    = 0.0f;
+                decay     = 0.0f;
+                sustain   = 1.0f;
+                release   = 0.0f;
+                envelope  = 1.0f;
+                maxLength = 0;
+
+                attackDuration   = 0.f;
+                attackValue      = 0.f;
+                attackIncrement  = 0.f;
+                decayDuration    = 0.f;
+                decayValue       = 0.f;
+                decayIncrement   = 0.f;
+                releaseDuration  = 0.f;
+                releaseValue     = 0.f;
+                releaseIncrement = 0.f;
+            }
+        };
+        ADSR adsr;
+
+        NoteLink link;     // position in the list of playing Notes (or the VoicePool while unused)
+        NoteLink heldLink; // position in the list of unreleased Notes
+        NoteLink arpLink;  // position in the arpeggiated sequence
+        int queueIndex;    // position in the VoiceQueue (-1 when not queued, e.g. when stolen)
+    };
+
+    // doubly linked list of Notes in order of insertion, the list uses the links
+    // stored inside the Notes (given by the link member) so adding and removing
+    // Notes is constant time and never allocates
+
+    struct NoteList {
+        Note* first;
+        Note* last;
+        int size;
+        NoteLink Note::* link;
+
+        NoteList( NoteLink Note::* linkMember ) : first( nullptr ), last( nullptr ), size( 0 ), link( linkMember ) {}
+
+        void add( Note* note ) {
+            ( note->*link ).previous = last;
+            ( note->*link ).next     = nullptr;
+
+            if ( last != nullptr ) {
+                ( last->*link ).next = note;
+            } else {
+                first = note;
+            }
+            last = note;
+            ++size;
+        }
+
+        void remove( Note* note ) {
+            Note* previous = ( note->*link ).previous;
+            Note* next     = ( note->*link ).next;
+
+            if ( previous != nullptr ) {
+                ( previous->*link ).next = next;
+            } else {
+                first = next;
+            }
+            if ( next != nullptr ) {
+                ( next->*link ).previous = previous;
+            } else {
+                last = previous;
+            }
+            ( note->*link ).previous = nullptr;
+            ( note->*link ).next     = nullptr;
+            --size;
+        }
+    };
+}
+
+#endif
@@ -44,6 +44,58 @@ enum
     kMasterTuningId,   // pitch bend (added in v1.1.0)
     kPitchBendRangeId, // pitch bend range (added in v1.1.0)
     kPortamentoId,     // portamento (added in v1.1.0)
+
+    // read-only meters, written by the processor (see DSPLoadMeter)
+    // loads are expressed in percentage of the block deadline
+
+    kSynthesisLoadId,  // average voice synthesis load
+    kSynthesisPeakId,  // peak voice synthesis load
+    kFilterLoadId,     // average filter load
+    kFilterPeakId,     // peak filter load
+    kRingModLoadId,    // average ring modulator load
+    kRingModPeakId,    // peak ring modulator load
+    kTotalLoadId,      // average load of the entire process call
+    kTotalPeakId,      // peak load of the entire process call
+    kActiveVoicesId,   // amount of currently synthesized voices
+
+    kBandLimitedId,    // band-limited oscillators (added after v1.1.2)
+    kMaxVoicesId,      // maximum amount of simultaneously playing voices (added after v1.1.2)
+    kVoiceStealingId,  // voice stealing policy (added after v1.1.2)
+    kMultiTimbralId,   // multi-timbral mode, playing a part per MIDI channel (added after v1.1.2)
+    kFilterModeId,     // filter response (added after v1.1.2)
+    kVoiceFilterId,    // filter each voice individually (added after v1.1.2)
+    kFilterEnvelopeId, // depth by which the cutoff follows the envelope of each voice (added after v1.1.2)
+    kFlushedValuesId,  // read-only meter: peak amount of state values flushed before becoming subnormal per block (added after v1.1.2)
+    kSynthesisMinId,   // read-only meter: minimum voice synthesis load (added after v1.1.2)
+    kFilterMinId,      // read-only meter: minimum filter load (added after v1.1.2)
+    kRingModMinId,     // read-only meter: minimum ring modulator load (added after v1.1.2)
+    kTotalMinId,       // read-only meter: minimum load of the entire process call (added after v1.1.2)
+};
+
+// the sound parameters of which each part of the multi-timbral mode has its own copy
+// (see Igorski::VST::getPartParameterId()), in order of their storage in the state
+
+static constexpr int PART_PARAMETERS[] = {
+    kAttackId, kDecayId, kSustainId, kReleaseId, kCutoffId, kResonanceId, kLFORateId,
+    kRingModRateId, kLFODepthId, kMasterTuningId, kPitchBendRangeId, kPortamentoId
 };
+static constexpr int PART_PARAMETER_AMOUNT = sizeof( PART_PARAMETERS ) / sizeof( int );
+
+// the highest id within PART_PARAMETERS
+
+constexpr int getHighestPartParameter()
+{
+    int highest = 0;
+    for ( int id : PART_PARAMETERS ) {
+        highest = id > highest ? id : highest;
+    }
+    return highest;
+}
+
+// the sound parameters that ramp linearly in between the points of their automation (instead
+// of changing at the sample offset of each point, see VSTSID::rampParameterChanges())
+
+static const int SMOOTHED_PARAMETERS[] = { kCutoffId, kResonanceId, kRingModRateId };
+static const int SMOOTHED_PARAMETER_AMOUNT = sizeof( SMOOTHED_PARAMETERS ) / sizeof( int );
 
 #endif
@@ -0,0 +1,220 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "part.h"
+#include "calc.h"
+#include "paramids.h"
+
+namespace Igorski {
+
+Part::Part()
+: fAttack( 0.f )
+, fDecay( 1.f )
+, fSustain( .5f )
+, fRelease( 0.f )
+, fCutoff( .5f )
+, fResonance( 0.f )
+, fLFORate( 0.f )
+, fLFODepth( 1.f )
+, fRingModRate( 0.f )
+, fMasterTuning( 0.f )
+, fPitchBendRange( 1.f )
+, fPortamento( 0.f )
+{
+    buffer = new double[ BUFFER_SIZE ]();
+}
+
+Part::~Part()
+{
+    delete synth;
+    delete filter;
+    delete[] buffer;
+}
+
+void Part::init( float sampleRate )
+{
+    if ( synth != nullptr ) {
+        delete synth;
+        delete filter;
+    }
+
+    synth = new Igorski::Synthesizer();
+    synth->init( sampleRate, 120.f );
+
+    filter = new Igorski::Filter( sampleRate );
+}
+
+bool Part::setParameter( int id, double value )
+{
+    switch ( id )
+    {
+        case kAttackId:
+            fAttack = ( float ) value;
+            break;
+
+        case kDecayId:
+            fDecay = ( float ) value;
+            break;
+
+        case kSustainId:
+            fSustain = ( float ) value;
+            break;
+
+        case kReleaseId:
+            fRelease = ( float ) value;
+            break;
+
+        case kCutoffId:
+            fCutoff = ( float ) value;
+            break;
+
+        case kResonanceId:
+            fResonance = ( float ) value;
+            break;
+
+        case kLFORateId:
+            fLFORate = ( float ) value;
+            break;
+
+        case kLFODepthId:
+            fLFODepth = ( float ) value;
+            break;
+
+        case kRingModRateId:
+            fRingModRate = ( float ) value;
+            break;
+
+        case kMasterTuningId:
+            fMasterTuning = 2 * ( value - 0.5f ); // -1 to +1 range
+            scaleTuning();
+            break;
+
+        case kPitchBendRangeId:
+            fPitchBendRange = ( float ) value;
+            scaleTuning();
+            break;
+
+        case kPortamentoId:
+            fPortamento = ( float ) value;
+            break;
+
+        default:
+            return false;
+    }
+    return true;
+}
+
+float Part::getParameter( int id )
+{
+    switch ( id )
+    {
+        case kAttackId:         return fAttack;
+        case kDecayId:          return fDecay;
+        case kSustainId:        return fSustain;
+        case kReleaseId:        return fRelease;
+        case kCutoffId:         return fCutoff;
+        case kResonanceId:      return fResonance;
+        case kLFORateId:        return fLFORate;
+        case kLFODepthId:       return fLFODepth;
+        case kRingModRateId:    return fRingModRate;
+        case kMasterTuningId:   return ( fMasterTuning + 1.f ) / 2.f;
+        case kPitchBendRangeId: return fPitchBendRange;
+        case kPortamentoId:     return fPortamento;
+    }
+    return 0.f;
+}
+
+void Part::syncModel( bool bandLimited, int maxVoices, int voiceStealing, int filterMode, bool voiceFilter, float filterEnvelope )
+{
+    synth->updateProperties( fAttack, fDecay, fSustain, fRelease, fRingModRate, _scaledTuning, fPortamento );
+    synth->setBandLimited( bandLimited );
+    synth->setMaxVoices( maxVoices );
+    synth->setVoiceStealing( voiceStealing );
+    filter->setMode( filterMode );
+    filter->setEnvelopeDepth( filterEnvelope );
+    filter->updateProperties( fCutoff, Calc::inverseNormalize( fResonance ), fLFORate, fLFODepth );
+
+    // the history of the Filter does not apply when switching between filtering the output and the voices
+
+    if ( voiceFilter != synth->hasVoiceFilter()) {
+        filter->reset();
+    }
+    synth->setVoiceFilter( voiceFilter ? filter : nullptr );
+}
+
+void Part::rampModel( int32 samples )
+{
+    synth->rampRingModRate( fRingModRate, samples );
+    filter->rampProperties( fCutoff, Calc::inverseNormalize( fResonance ), samples );
+}
+
+void Part::completeRamps()
+{
+    synth->completeRamps();
+    filter->completeRamp();
+}
+
+void Part::scaleTuning()
+{
+    _scaledTuning = Calc::pitchShiftFactor( fMasterTuning * round( fPitchBendRange * VST::MAX_PITCH_BEND ));
+}
+
+bool Part::isIdle()
+{
+    return synth->getVoiceAmount() == 0 && !filter->hasTail();
+}
+
+void Part::noteOn( int16 pitch, float normalizedVelocity, float tuning )
+{
+    synth->noteOn( pitch, normalizedVelocity, tuning );
+}
+
+void Part::noteOff( int16 pitch )
+{
+    synth->noteOff( pitch );
+}
+
+void Part::releaseAll()
+{
+    for ( int16 pitch = 0; pitch < 128; ++pitch ) {
+        synth->noteOff( pitch );
+    }
+}
+
+int Part::getVoiceAmount()
+{
+    return synth->getVoiceAmount();
+}
+
+int Part::getTailSamples()
+{
+    // the release of the last Note followed by the decay of the filter
+
+    return synth->getReleaseSamples() + filter->getTailSamples();
+}
+
+int Part::collectFlushedValues()
+{
+    return synth->collectFlushedValues() + filter->collectFlushedValues();
+}
+
+} // E.O. namespace Igorski
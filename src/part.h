@@ -0,0 +1,124 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __PART_HEADER__
+#define __PART_HEADER__
+
+#include "global.h"
+#include "synth.h"
+#include "filter.h"
+#include "dspmeter.h"
+
+namespace Igorski {
+
+    /**
+     * A Synthesizer and Filter chain along with its model (the sound parameters). In
+     * single-timbral mode all notes are played by the first part, while in multi-timbral
+     * mode each MIDI channel plays its own part (which can be rendered in parallel)
+     */
+    class Part {
+
+        public:
+            Part();
+            ~Part();
+
+            // (re)creates the Synthesizer and Filter for given sample rate
+            void init( float sampleRate );
+
+            // our model values, these are all 0 - 1 range
+            // (normalized) RangeParameter values (except for fMasterTuning, in -1 to +1 range)
+
+            float fAttack;
+            float fDecay;
+            float fSustain;
+            float fRelease;
+
+            float fCutoff;
+            float fResonance;
+            float fLFORate;
+            float fLFODepth;
+
+            float fRingModRate;
+            float fMasterTuning;
+            float fPitchBendRange;
+            float fPortamento;
+
+            // applies the normalized value of given sound parameter, returns false when given
+            // id is not one of the sound parameters (see PART_PARAMETERS) / returns the normalized value
+            bool setParameter( int id, double value );
+            float getParameter( int id );
+
+            // synchronize the Synthesizer and Filter with the model, given properties are shared by all parts
+            // when voiceFilter is true, the Filter is applied to each voice individually (see Synthesizer::setVoiceFilter())
+            void syncModel( bool bandLimited, int maxVoices, int voiceStealing, int filterMode, bool voiceFilter, float filterEnvelope );
+            void scaleTuning();
+
+            // ramps the Filter and ring modulator from their current properties towards the model values of the smoothed
+            // sound parameters (see SMOOTHED_PARAMETERS) over the next given amount of rendered samples. completeRamps()
+            // applies the model values immediately (e.g. once the range has been rendered, or skipped when idle)
+            void rampModel( int32 samples );
+            void completeRamps();
+
+            // whether no Notes are playing and the filter has rung out
+            bool isIdle();
+
+            // renders given amount of samples into given (mono) output buffer, where blockOffset is its position
+            // within the hosts block. Returns false (leaving the output untouched) when silent. When provided,
+            // the load of each stage is measured by given load meter
+            template <typename SampleType>
+            bool render( SampleType* output, int32 blockOffset, int32 length, DSPLoadMeter* loadMeter );
+
+            void noteOn( int16 pitch, float normalizedVelocity, float tuning );
+            void noteOff( int16 pitch );
+
+            // releases all Notes (e.g. when the part no longer receives note events)
+            void releaseAll();
+
+            int getVoiceAmount();
+            int getTailSamples();
+
+            // the amount of filter and ring modulator state values flushed to zero (as these were decaying
+            // towards the subnormal range) since the last invocation, after which the count restarts
+            int collectFlushedValues();
+
+            // the tempo (in BPM) and sample rate as provided by the host
+            double getTempo() { return synth->TEMPO; }
+            void setTempo( int sampleRate, double tempo ) { synth->init( sampleRate, tempo ); }
+
+            // output buffer used when rendering alongside other parts, along with whether content was rendered into it
+            // its size is the maximum amount of samples rendered at once (double precision fits single precision samples)
+
+            static constexpr int32 BUFFER_SIZE = 1024;
+            double* buffer = nullptr;
+            bool rendered = false;
+
+        private:
+            Synthesizer* synth  = nullptr;
+            Filter*      filter = nullptr;
+
+            float _scaledTuning = 1.f;
+    };
+}
+
+#include "part.tcc"
+
+#endif
@@ -0,0 +1,58 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+namespace Igorski {
+
+template <typename SampleType>
+bool Part::render( SampleType* output, int32 blockOffset, int32 length, DSPLoadMeter* loadMeter )
+{
+    if ( loadMeter ) loadMeter->startStage();
+    bool hasContent = synth->synthesize<SampleType>( output, length, blockOffset );
+    if ( loadMeter ) loadMeter->endStage( DSPLoadMeter::SYNTHESIS );
+
+    if ( hasContent ) {
+        if ( loadMeter ) loadMeter->startStage();
+        synth->ringModulate<SampleType>( output, length );
+        if ( loadMeter ) loadMeter->endStage( DSPLoadMeter::RING_MODULATOR );
+    } else {
+        // no Notes are playing, though the filter can still be ringing out their output
+        // once it has decayed into silence, the part is idle and no processing takes place
+
+        if ( !filter->hasTail() ) {
+            filter->reset();
+            return false;
+        }
+        memset( output, 0, length * sizeof( SampleType ));
+    }
+
+    // when filtered per voice, the filter has already been applied during synthesis
+
+    if ( !synth->hasVoiceFilter() ) {
+        if ( loadMeter ) loadMeter->startStage();
+        filter->process<SampleType>( output, length );
+        if ( loadMeter ) loadMeter->endStage( DSPLoadMeter::FILTER );
+    }
+
+    return true;
+}
+
+} // E.O. namespace Igorski
@@ -0,0 +1,82 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __POLYBLEP_HEADER__
+#define __POLYBLEP_HEADER__
+
+#include "simd.h"
+
+/**
+ * polynomial approximations of the residual between a naive (aliasing)
+ * discontinuity and its band-limited counterpart. Adding the residual to the
+ * samples surrounding a discontinuity of an oscillator removes most of the
+ * aliasing it causes, without needing to oversample the oscillator.
+ *
+ * All functions operate on either a single voice (Vector is float) or a group
+ * of voices (Vector is SIMD::float4), where position is the normalized (0 - 1)
+ * phase relative to the discontinuity and increment the normalized phase increment
+ * per sample. The residual spans a single sample on either side of the discontinuity.
+ */
+namespace Igorski {
+namespace PolyBLEP {
+
+    /**
+     * residual of a step discontinuity (e.g. the edges of a pulse wave), for
+     * a jump in value of 2 (scale linearly for other sizes)
+     */
+    template <typename Vector>
+    inline Vector step( Vector position, Vector increment, Vector inverseIncrement )
+    {
+        using namespace SIMD;
+
+        const Vector one( 1.f );
+
+        Vector after  = position * inverseIncrement;           // 0 - 1 samples past the discontinuity
+        Vector before = ( position - one ) * inverseIncrement; // -1 - 0 samples ahead of the discontinuity
+
+        Vector residual = select( greaterThan( position, one - increment ), before * before + before + before + one, Vector( 0.f ));
+        return select( lessThan( position, increment ), after + after - after * after - one, residual );
+    }
+
+    /**
+     * residual of a ramp discontinuity (e.g. the corners of a triangle wave), for a
+     * change in slope of 1 per sample (scale linearly for other sizes)
+     */
+    template <typename Vector>
+    inline Vector ramp( Vector position, Vector increment, Vector inverseIncrement )
+    {
+        using namespace SIMD;
+
+        const Vector one( 1.f );
+        const Vector sixth( 1.f / 6.f );
+
+        Vector after  = one - position * inverseIncrement;           // 1 - 0 past the discontinuity
+        Vector before = ( position - one ) * inverseIncrement + one; // 0 - 1 ahead of the discontinuity
+
+        Vector residual = select( greaterThan( position, one - increment ), before * before * before * sixth, Vector( 0.f ));
+        return select( lessThan( position, increment ), after * after * after * sixth, residual );
+    }
+
+} // E.O. namespace PolyBLEP
+} // E.O. namespace Igorski
+
+#endif
@@ -41,7 +41,11 @@ RingModulator::RingModulator()
     fPhi  = 0.f;
     twoPi = ( float ) 6.2831853f;
     fprev = 0.f;
-    
+
+    flushedValues = 0;
+    rampSamples = 0;
+    fdPhiStep   = 0.f;
+
     recalculate();
 }
 
@@ -59,18 +63,53 @@ void RingModulator::setRate( float ratePercentage )
     // 0.0625 is 1 kHz, divide 1000 to get the per-Hz value
     _rate = ( 0.0625f / 1000.f ) * rate;
 
+    rampSamples = 0;
     recalculate();
 }
 
+void RingModulator::rampRate( float ratePercentage, int samples )
+{
+    completeRamp();
+
+    float currentPhi = fdPhi;
+    bool wasOff      = _rate == 0.f;
+
+    setRate( ratePercentage );
+
+    if ( samples <= 0 || wasOff || _rate == 0.f || fdPhi == currentPhi ) {
+        return;
+    }
+    fdPhiTarget = fdPhi;
+    fdPhiStep   = ( fdPhiTarget - currentPhi ) / ( float ) samples;
+    fdPhi       = currentPhi;
+    rampSamples = samples;
+}
+
+void RingModulator::completeRamp()
+{
+    if ( rampSamples > 0 ) {
+        fdPhi       = fdPhiTarget;
+        rampSamples = 0;
+    }
+}
+
 float RingModulator::getRate()
 {
     return _rate;
 }
 
+int RingModulator::collectFlushedValues()
+{
+    int flushed = flushedValues;
+    flushedValues = 0;
+    return flushed;
+}
+
 //-----------------------------------------------------------------------------
 void RingModulator::recalculate ()
 {
-    fdPhi = ( float ) ( twoPi * 100.f * ( _fine + ( 160.f * _rate )) / VST::SAMPLE_RATE );
+    fdPhi       = ( float ) ( twoPi * 100.f * ( _fine + ( 160.f * _rate )) / VST::SAMPLE_RATE );
+    fdPhiTarget = fdPhi;
     ffb   = 0.95f * _feedback;
 }
 
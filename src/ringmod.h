@@ -25,6 +25,9 @@
 #define __RING_MOD_HEADER__
 
 #include "global.h"
+#include "denormals.h"
+#include <algorithm>
+#include <math.h>
 
 namespace Steinberg {
 namespace Vst {
@@ -36,8 +39,9 @@ class RingModulator
         RingModulator();
         ~RingModulator();
 
-        template <typename SampleType>    
-        void apply( SampleType** outputBuffers, int numChannels, int bufferSize, uint32 sampleFramesSize );
+        // apply the ring modulation onto given (mono) buffer
+        template <typename SampleType>
+        void apply( SampleType* buffer, int bufferSize );
 
         // set the rate of the ring modulator to a percentage (0 - 1) range
         // of its maximum range (see global.h)
@@ -45,6 +49,16 @@ class RingModulator
         void setRate( float ratePercentage );
         float getRate();
 
+        // ramps the rate linearly from its current value towards given rate (in the same range as setRate()) over
+        // the next given amount of processed samples (e.g. in between the points of its automation), completeRamp()
+        // applies the rate at the end of the ramp immediately. Switching the ring modulator on or off is not ramped
+        void rampRate( float ratePercentage, int samples );
+        void completeRamp();
+
+        // the amount of times the feedback was flushed to zero (see Denormals::flush())
+        // since the last invocation, after which the count restarts
+        int collectFlushedValues();
+
     protected:
 
         void recalculate();
@@ -58,6 +72,11 @@ class RingModulator
         float nul;
         float twoPi;
         float ffb, fprev;
+        int flushedValues;
+
+        // phase increment at the end of the ramp, its change per sample and the remaining ramp duration
+        float fdPhiTarget, fdPhiStep;
+        int32 rampSamples;
 };
 
 }}}
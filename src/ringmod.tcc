@@ -3,8 +3,7 @@ namespace Vst {
 namespace mda {
 
 template <typename SampleType>
-void RingModulator::apply( SampleType** outputBuffers, int numChannels,
-                           int bufferSize, uint32 sampleFramesSize )
+void RingModulator::apply( SampleType* buffer, int bufferSize )
 {
     // if ring modulation is off, don't do anything
     if ( _rate == 0.f )
@@ -12,28 +11,27 @@ void RingModulator::apply( SampleType** outputBuffers, int numChannels,
 
     int32 sampleFrames = bufferSize;
 
-    SampleType* in1  = outputBuffers[ 0 ];
-    SampleType* in2  = outputBuffers[ 1 ];
-    SampleType* out1 = outputBuffers[ 0 ];
-    SampleType* out2 = outputBuffers[ 1 ];
+    SampleType* in  = buffer;
+    SampleType* out = buffer;
 
-    SampleType a, b, c, d, g;
-    SampleType p, dp, tp = twoPi, fb, fp, fp2;
+    SampleType a, g;
+    SampleType p, dp, tp = twoPi, fb, fp;
 
     p  = fPhi;
     dp = fdPhi;
     fb = ffb;
     fp = fprev;
 
-    --in1;
-    --in2;
-    --out1;
-    --out2;
+    SampleType dpStep = fdPhiStep;
+    int32 rampFrames  = std::min( sampleFrames, rampSamples ); // samples over which the phase increment ramps (see rampRate())
+    rampSamples -= rampFrames;
+
+    --in;
+    --out;
 
     while (--sampleFrames >= 0)
     {
-        a = *++in1;
-        b = *++in2;
+        a = *++in;
 
         g = ( SampleType ) sin( p );
 
@@ -47,17 +45,17 @@ void RingModulator::apply( SampleType** outputBuffers, int numChannels,
 
         p = ( SampleType ) fmod( p + dp, tp );
 
-        fp  = ( fb * fp + a ) * g;
-        fp2 = ( fb * fp + b ) * g;
+        if ( --rampFrames >= 0 ) {
+            dp += dpStep;
+        }
 
-        c = fp;
-        d = fp2;
+        fp = ( fb * fp + a ) * g;
 
-        *++out1 = static_cast<SampleType>( c );
-        *++out2 = static_cast<SampleType>( d );
+        *++out = static_cast<SampleType>( fp );
     }
     fPhi  = p;
-    fprev = fp;
+    fdPhi = ( rampSamples == 0 ) ? fdPhiTarget : ( float ) dp; // the end of the ramp is applied exactly
+    fprev = Igorski::Denormals::flush(( float ) fp, flushedValues ); // decays towards zero once the input falls silent
 }
 
 }}}
\ No newline at end of file
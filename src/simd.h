@@ -0,0 +1,231 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __SIMD_HEADER__
+#define __SIMD_HEADER__
+
+#include <string.h>
+#include <stdint.h>
+
+// SSE2 is part of the x86-64 baseline (and NEON of AArch64), other
+// targets fall back to a scalar implementation of the same interface
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define VSTSID_SIMD_SSE
+#include <emmintrin.h>
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+#define VSTSID_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Igorski {
+namespace SIMD {
+
+    // the amount of values processed by a single instruction
+
+    static const int LANES = 4;
+
+    /**
+     * four single precision values that are processed in parallel. Comparisons
+     * return masks (all bits set for lanes where the comparison holds) to be used
+     * with select() instead of branching
+     */
+#if defined( VSTSID_SIMD_SSE )
+
+    struct float4 {
+        __m128 v;
+
+        float4() {}
+        float4( __m128 value ) : v( value ) {}
+        float4( float value ) : v( _mm_set1_ps( value )) {}
+
+        static float4 load( const float* aligned ) { return _mm_load_ps( aligned ); }
+        void store( float* aligned ) const { _mm_store_ps( aligned, v ); }
+    };
+
+    inline float4 operator+( float4 a, float4 b ) { return _mm_add_ps( a.v, b.v ); }
+    inline float4 operator-( float4 a, float4 b ) { return _mm_sub_ps( a.v, b.v ); }
+    inline float4 operator*( float4 a, float4 b ) { return _mm_mul_ps( a.v, b.v ); }
+    inline float4 operator/( float4 a, float4 b ) { return _mm_div_ps( a.v, b.v ); }
+    inline float4 operator&( float4 a, float4 b ) { return _mm_and_ps( a.v, b.v ); }
+
+    inline float4 lessThan   ( float4 a, float4 b ) { return _mm_cmplt_ps( a.v, b.v ); }
+    inline float4 greaterThan( float4 a, float4 b ) { return _mm_cmpgt_ps( a.v, b.v ); }
+
+    // returns a where mask is set, b otherwise
+    inline float4 select( float4 mask, float4 a, float4 b ) {
+        return _mm_or_ps( _mm_and_ps( mask.v, a.v ), _mm_andnot_ps( mask.v, b.v ));
+    }
+
+    inline float4 abs( float4 a ) {
+        return _mm_andnot_ps( _mm_set1_ps( -0.f ), a.v );
+    }
+
+    // sum of all lanes
+    inline float sum( float4 a ) {
+        __m128 shuffled = _mm_shuffle_ps( a.v, a.v, _MM_SHUFFLE( 2, 3, 0, 1 ));
+        __m128 sums     = _mm_add_ps( a.v, shuffled );
+        shuffled        = _mm_movehl_ps( shuffled, sums );
+        return _mm_cvtss_f32( _mm_add_ss( sums, shuffled ));
+    }
+
+#elif defined( VSTSID_SIMD_NEON )
+
+    struct float4 {
+        float32x4_t v;
+
+        float4() {}
+        float4( float32x4_t value ) : v( value ) {}
+        float4( float value ) : v( vdupq_n_f32( value )) {}
+
+        static float4 load( const float* aligned ) { return vld1q_f32( aligned ); }
+        void store( float* aligned ) const { vst1q_f32( aligned, v ); }
+    };
+
+    inline float4 operator+( float4 a, float4 b ) { return vaddq_f32( a.v, b.v ); }
+    inline float4 operator-( float4 a, float4 b ) { return vsubq_f32( a.v, b.v ); }
+    inline float4 operator*( float4 a, float4 b ) { return vmulq_f32( a.v, b.v ); }
+    inline float4 operator&( float4 a, float4 b ) {
+        return vreinterpretq_f32_u32( vandq_u32( vreinterpretq_u32_f32( a.v ), vreinterpretq_u32_f32( b.v )));
+    }
+
+    inline float4 operator/( float4 a, float4 b ) {
+#if defined( __aarch64__ )
+        return vdivq_f32( a.v, b.v );
+#else
+        // ARMv7 lacks a division instruction, refine the reciprocal estimate
+        float32x4_t reciprocal = vrecpeq_f32( b.v );
+        reciprocal = vmulq_f32( vrecpsq_f32( b.v, reciprocal ), reciprocal );
+        reciprocal = vmulq_f32( vrecpsq_f32( b.v, reciprocal ), reciprocal );
+        return vmulq_f32( a.v, reciprocal );
+#endif
+    }
+
+    inline float4 lessThan   ( float4 a, float4 b ) { return vreinterpretq_f32_u32( vcltq_f32( a.v, b.v )); }
+    inline float4 greaterThan( float4 a, float4 b ) { return vreinterpretq_f32_u32( vcgtq_f32( a.v, b.v )); }
+
+    inline float4 select( float4 mask, float4 a, float4 b ) {
+        return vbslq_f32( vreinterpretq_u32_f32( mask.v ), a.v, b.v );
+    }
+
+    inline float4 abs( float4 a ) {
+        return vabsq_f32( a.v );
+    }
+
+    inline float sum( float4 a ) {
+        float32x2_t sums = vadd_f32( vget_low_f32( a.v ), vget_high_f32( a.v ));
+        return vget_lane_f32( vpadd_f32( sums, sums ), 0 );
+    }
+
+#else
+
+    struct float4 {
+        float v[ LANES ];
+
+        float4() {}
+        float4( float value ) { for ( int i = 0; i < LANES; ++i ) v[ i ] = value; }
+
+        static float4 load( const float* aligned ) { float4 out; memcpy( out.v, aligned, sizeof( out.v )); return out; }
+        void store( float* aligned ) const { memcpy( aligned, v, sizeof( v )); }
+    };
+
+    namespace Scalar {
+        template <typename Operation>
+        inline float4 apply( float4 a, float4 b, Operation operation ) {
+            float4 out;
+            for ( int i = 0; i < LANES; ++i ) out.v[ i ] = operation( a.v[ i ], b.v[ i ]);
+            return out;
+        }
+        inline float mask( bool value ) {
+            uint32_t bits = value ? 0xFFFFFFFF : 0;
+            float out;
+            memcpy( &out, &bits, sizeof( float ));
+            return out;
+        }
+        inline uint32_t bits( float value ) {
+            uint32_t out;
+            memcpy( &out, &value, sizeof( float ));
+            return out;
+        }
+        inline float fromBits( uint32_t value ) {
+            float out;
+            memcpy( &out, &value, sizeof( float ));
+            return out;
+        }
+    }
+
+    inline float4 operator+( float4 a, float4 b ) { return Scalar::apply( a, b, []( float x, float y ) { return x + y; }); }
+    inline float4 operator-( float4 a, float4 b ) { return Scalar::apply( a, b, []( float x, float y ) { return x - y; }); }
+    inline float4 operator*( float4 a, float4 b ) { return Scalar::apply( a, b, []( float x, float y ) { return x * y; }); }
+    inline float4 operator/( float4 a, float4 b ) { return Scalar::apply( a, b, []( float x, float y ) { return x / y; }); }
+    inline float4 operator&( float4 a, float4 b ) {
+        return Scalar::apply( a, b, []( float x, float y ) { return Scalar::fromBits( Scalar::bits( x ) & Scalar::bits( y )); });
+    }
+
+    inline float4 lessThan   ( float4 a, float4 b ) { return Scalar::apply( a, b, []( float x, float y ) { return Scalar::mask( x < y ); }); }
+    inline float4 greaterThan( float4 a, float4 b ) { return Scalar::apply( a, b, []( float x, float y ) { return Scalar::mask( x > y ); }); }
+
+    inline float4 select( float4 mask, float4 a, float4 b ) {
+        float4 out;
+        for ( int i = 0; i < LANES; ++i ) out.v[ i ] = Scalar::bits( mask.v[ i ]) != 0 ? a.v[ i ] : b.v[ i ];
+        return out;
+    }
+
+    inline float4 abs( float4 a ) {
+        float4 out;
+        for ( int i = 0; i < LANES; ++i ) out.v[ i ] = a.v[ i ] < 0.f ? -a.v[ i ] : a.v[ i ];
+        return out;
+    }
+
+    inline float sum( float4 a ) {
+        return ( a.v[ 0 ] + a.v[ 1 ]) + ( a.v[ 2 ] + a.v[ 3 ]);
+    }
+
+#endif
+
+    // single precision counterparts of the above, allowing the same code to be
+    // written for a full group of values and for a single value
+
+    inline bool lessThan   ( float a, float b ) { return a < b; }
+    inline bool greaterThan( float a, float b ) { return a > b; }
+    inline float select( bool mask, float a, float b ) { return mask ? a : b; }
+    inline float abs( float a ) { return a < 0.f ? -a : a; }
+    inline float sum( float a ) { return a; }
+
+    // returns value where mask is set, 0 otherwise
+
+    inline float4 mask( float4 value, float4 condition ) { return value & condition; }
+    inline float mask( float value, bool condition ) { return condition ? value : 0.f; }
+
+    // loads/stores LANES consecutive values (aligned) from/into a float4 or a single value from/into a float
+
+    template <typename Vector> inline Vector load( const float* values );
+    template <> inline float4 load<float4>( const float* values ) { return float4::load( values ); }
+    template <> inline float load<float>( const float* values ) { return *values; }
+
+    inline void store( float* values, float4 value ) { value.store( values ); }
+    inline void store( float* values, float value ) { *values = value; }
+
+} // E.O. namespace SIMD
+} // E.O. namespace Igorski
+
+#endif
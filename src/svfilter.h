@@ -0,0 +1,118 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __SVFILTER_H_INCLUDED__
+#define __SVFILTER_H_INCLUDED__
+
+#include "global.h"
+#include "calc.h"
+#include "denormals.h"
+#include "simd.h"
+
+namespace Igorski {
+
+    // the responses provided by the StateVariableFilter
+
+    enum SVFModes
+    {
+        LOW_PASS,
+        BAND_PASS,
+        HIGH_PASS
+    };
+
+    /**
+     * Zero-delay feedback state variable filter, derived by applying the topology-preserving
+     * transform (trapezoidal integration) to the analog state variable filter. Its low-, band- and
+     * high-pass responses are all available from the same two integrator states and unlike the
+     * biquad its state remains valid when its coefficients change each sample, so its cutoff can be
+     * swept at audio rate. At equal cutoff and damping the low-pass response matches that of Filter
+     *
+     * Vector is either SIMD::float4, in which case four independent lanes (e.g. channels or voices,
+     * each with their own cutoff) are filtered per instruction, or float for a single lane
+     */
+    template <typename Vector>
+    class StateVariableFilter {
+
+        public:
+            StateVariableFilter( float sampleRate );
+
+            // calculates the coefficients for given cutoff frequency (in Hz) and damping (the inverse of the
+            // filters quality factor, e.g. the resonance of Filter) of each lane, these apply immediately
+            void setCoefficients( Vector cutoff, Vector damping );
+
+            // calculates the coefficients for given cutoff frequency and damping towards which the next call
+            // to process() (in modulated form) ramps the current coefficients over given amount of samples. This
+            // takes a single tangent per lane, in between the coefficients are interpolated linearly
+            void rampCoefficients( Vector cutoff, Vector damping, int length );
+
+            // filters given amount of samples in place, using the response of given mode (see SVFModes). When
+            // modulated, the coefficients are ramped towards those provided to rampCoefficients() (of which
+            // given length must be the ramp length). SampleType is either float or double for a single lane
+            // or SIMD::float4 where each value holds a sample for each lane (in structure-of-arrays form)
+            template <int mode, bool modulated, typename SampleType>
+            void process( SampleType* samples, int length );
+
+            // whether any lane is still ringing out previously processed input (e.g. its
+            // state has not decayed below VST::SILENCE_THRESHOLD), when not it can be reset()
+            bool hasTail();
+            void reset();
+
+            // the integrator states of all lanes, allowing a single filter to process
+            // multiple sets of lanes in turn (e.g. the groups of voices of a VoiceBank)
+            void getState( Vector& ic1eq, Vector& ic2eq );
+            void setState( Vector ic1eq, Vector ic2eq );
+
+            // the amount of integrator states (per lane) flushed to zero (see Denormals::flush())
+            // since the last invocation, after which the count restarts
+            int collectFlushedValues();
+
+        private:
+            float _sampleRate;
+
+            // the coefficients of the current and ramped towards responses, for the integrators
+            // solved in state-space form (see calculateCoefficients())
+
+            struct Coefficients {
+                Vector c1;
+                Vector c2;
+                Vector c3;
+                Vector c4;
+                Vector k; // damping
+            };
+            Coefficients _current;
+            Coefficients _target;
+            Coefficients _step;
+
+            // state of the two integrators
+
+            Vector _ic1eq;
+            Vector _ic2eq;
+
+            int _flushedValues;
+
+            Coefficients calculateCoefficients( Vector cutoff, Vector damping );
+    };
+}
+
+#include "svfilter.tcc"
+
+#endif
@@ -0,0 +1,188 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+namespace Igorski {
+
+template <typename Vector>
+StateVariableFilter<Vector>::StateVariableFilter( float sampleRate )
+{
+    _sampleRate    = sampleRate;
+    _flushedValues = 0;
+
+    setCoefficients( Vector( VST::FILTER_MAX_FREQ / 2 ), Vector( VST::FILTER_MAX_RESONANCE ));
+    reset();
+}
+
+template <typename Vector>
+void StateVariableFilter<Vector>::setCoefficients( Vector cutoff, Vector damping )
+{
+    _current = calculateCoefficients( cutoff, damping );
+    _target  = _current;
+
+    _step.c1 = Vector( 0.f );
+    _step.c2 = Vector( 0.f );
+    _step.c3 = Vector( 0.f );
+    _step.c4 = Vector( 0.f );
+    _step.k  = Vector( 0.f );
+}
+
+template <typename Vector>
+void StateVariableFilter<Vector>::rampCoefficients( Vector cutoff, Vector damping, int length )
+{
+    _target = calculateCoefficients( cutoff, damping );
+
+    Vector inverseLength = Vector( 1.f / ( float ) length );
+
+    _step.c1 = ( _target.c1 - _current.c1 ) * inverseLength;
+    _step.c2 = ( _target.c2 - _current.c2 ) * inverseLength;
+    _step.c3 = ( _target.c3 - _current.c3 ) * inverseLength;
+    _step.c4 = ( _target.c4 - _current.c4 ) * inverseLength;
+
+    // the damping is not ramped (it only changes along with the model)
+    _current.k = _target.k;
+}
+
+template <typename Vector>
+template <int mode, bool modulated, typename SampleType>
+void StateVariableFilter<Vector>::process( SampleType* samples, int length )
+{
+    // local copies of the state and coefficients as the writes to samples could otherwise alias the members
+
+    Vector ic1eq = _ic1eq;
+    Vector ic2eq = _ic2eq;
+
+    Vector c1 = _current.c1;
+    Vector c2 = _current.c2;
+    Vector c3 = _current.c3;
+    Vector c4 = _current.c4;
+    Vector k  = _current.k;
+
+    Coefficients step = _step;
+
+    const Vector half = Vector( .5f );
+
+    for ( int i = 0; i < length; ++i )
+    {
+        Vector v0 = ( Vector ) samples[ i ];
+
+        // advance the integrators, these only depend on each other by a multiplication and two additions
+
+        Vector ic1 = c1 * ic1eq + c2 * ( v0 - ic2eq );
+        Vector ic2 = ( c2 * ic1eq + c3 * v0 ) + c4 * ic2eq;
+
+        // the band- and low-pass outputs lie halfway the previous and current integrator states
+
+        Vector v1 = half * ( ic1eq + ic1 );
+        Vector v2 = half * ( ic2eq + ic2 );
+
+        ic1eq = ic1;
+        ic2eq = ic2;
+
+        if constexpr ( mode == SVFModes::LOW_PASS ) {
+            samples[ i ] = ( SampleType ) v2;
+        } else if constexpr ( mode == SVFModes::BAND_PASS ) {
+            samples[ i ] = ( SampleType ) v1;
+        } else {
+            samples[ i ] = ( SampleType ) ( v0 - k * v1 - v2 );
+        }
+
+        if constexpr ( modulated ) {
+            c1 = c1 + step.c1;
+            c2 = c2 + step.c2;
+            c3 = c3 + step.c3;
+            c4 = c4 + step.c4;
+        }
+    }
+    _ic1eq = Denormals::flush( ic1eq, _flushedValues );
+    _ic2eq = Denormals::flush( ic2eq, _flushedValues );
+
+    // the ramp has completed, prevent accumulating rounding errors
+    if constexpr ( modulated ) {
+        _current = _target;
+    }
+}
+
+template <typename Vector>
+bool StateVariableFilter<Vector>::hasTail()
+{
+    return SIMD::sum( SIMD::abs( _ic1eq ) + SIMD::abs( _ic2eq )) > VST::SILENCE_THRESHOLD;
+}
+
+template <typename Vector>
+void StateVariableFilter<Vector>::reset()
+{
+    _ic1eq = Vector( 0.f );
+    _ic2eq = Vector( 0.f );
+}
+
+template <typename Vector>
+void StateVariableFilter<Vector>::getState( Vector& ic1eq, Vector& ic2eq )
+{
+    ic1eq = _ic1eq;
+    ic2eq = _ic2eq;
+}
+
+template <typename Vector>
+void StateVariableFilter<Vector>::setState( Vector ic1eq, Vector ic2eq )
+{
+    _ic1eq = ic1eq;
+    _ic2eq = ic2eq;
+}
+
+template <typename Vector>
+int StateVariableFilter<Vector>::collectFlushedValues()
+{
+    int flushedValues = _flushedValues;
+    _flushedValues = 0;
+    return flushedValues;
+}
+
+template <typename Vector>
+typename StateVariableFilter<Vector>::Coefficients StateVariableFilter<Vector>::calculateCoefficients( Vector cutoff, Vector damping )
+{
+    Vector g = Calc::fastTan( Vector( 3.141592653589793f / _sampleRate ) * cutoff );
+
+    Vector a1 = Vector( 1.f ) / ( Vector( 1.f ) + g * ( g + damping ));
+    Vector a2 = g * a1;
+    Vector a3 = g * a2;
+
+    // the integrators of the filter (where v0 is the input) are solved as
+    //
+    // v1    = a1 * ic1eq + a2 * ( v0 - ic2eq ) (band-pass)
+    // v2    = ic2eq + a2 * ic1eq + a3 * ( v0 - ic2eq ) (low-pass)
+    // ic1eq = 2 * v1 - ic1eq
+    // ic2eq = 2 * v2 - ic2eq
+    //
+    // which after substitution advance the integrators without the intermediate outputs
+
+    Coefficients coefficients;
+
+    coefficients.c1 = Vector( 2.f ) * a1 - Vector( 1.f );
+    coefficients.c2 = Vector( 2.f ) * a2;
+    coefficients.c3 = Vector( 2.f ) * a3;
+    coefficients.c4 = Vector( 1.f ) - coefficients.c3;
+    coefficients.k  = damping;
+
+    return coefficients;
+}
+
+} // E.O. namespace Igorski
@@ -22,7 +22,9 @@
  */
 #include "synth.h"
 #include "calc.h"
+#include "envelope.h"
 #include "miditable.h"
+#include "polyblep.h"
 #include <algorithm>
 #include <math.h>
 #include <climits>
@@ -31,7 +33,9 @@ using namespace Steinberg;
 
 namespace Igorski {
 
-Synthesizer::Synthesizer()
+static_assert( VoiceBank::MAX_SEGMENT_SIZE <= Filter::MAX_VOICE_SEGMENT_SIZE, "voice bank segments exceed the size filtered per voice" );
+
+Synthesizer::Synthesizer( int maxPolyphony )
 {
     TEMPO = 120.f;
 
@@ -41,9 +45,28 @@ Synthesizer::Synthesizer()
     MAX_ENVELOPE_SAMPLES = 44100;
     ARPEGGIO_DURATION    = 16;
 
+    props.pitchBend = 1.f;
+    pitchBend       = 1.f;
+
     ringModulator = new Steinberg::Vst::mda::RingModulator();
 
-    note_ids = 0;
+    // preallocate all Notes so no allocations occur on note events
+
+    voicePool.init( maxPolyphony );
+    voiceBank.init( maxPolyphony );
+    voiceQueue.init( maxPolyphony );
+    arpeggioFrequencies.resize( maxPolyphony, 0.f );
+    pendingRemovals.reserve( maxPolyphony );
+
+    for ( int i = 0; i < 128; ++i ) {
+        notesByPitch[ i ]       = nullptr;
+        pitchHistoryOwners[ i ] = nullptr;
+    }
+
+    note_ids      = 0;
+    noteOrder     = 0;
+    maxVoices     = maxPolyphony;
+    voiceStealing = VoiceStealing::RELEASED_FIRST;
 }
 
 Synthesizer::~Synthesizer() {
@@ -67,37 +90,33 @@ void Synthesizer::init( int sampleRate, double tempo )
 void Synthesizer::noteOn( int16 pitch, float normalizedVelocity, float tuning )
 {
     // do not allow a noteOn for the same pitch twice
-    if ( getExistingNote( pitch ) != nullptr )
-        removeNote( getExistingNote( pitch ));
+    Note* note = getExistingNote( pitch );
 
-    Note* note = nullptr;
+    if ( note != nullptr ) {
+        removeNote( note );
+        note = nullptr;
+    }
 
     if ( doGlide() ) {
 
         // when glide/portamento is enabled, get the previous sounding note
-        // that currently isn't gliding
-
-        for ( size_t i = 0, l = notes.size(); i < l; ++i ) {
-            auto compareNote = notes.at( i );
-            if ( /*!compareNote->portamento.enabled &&*/ !compareNote->released ) {
-                // store the last/original pitch that the note is synthesizing in the orgPitches list
-                // so we can return to the pitch (if it hasn't been noteOff'ed yet) on noteOff
-                auto list = compareNote->portamento.orgPitches;
-                if ( std::find( std::begin( list ), std::end( list ), compareNote->pitch ) == std::end( list )) {
-                    compareNote->portamento.orgPitches.push_back( compareNote->pitch );
-                }
-                note = compareNote;
-                note->pitch = pitch; // update "ownership" of note by adjusting pitch
-                break;
-            }
-        }
+        // that currently isn't gliding (e.g. the first unreleased note)
+
+        note = heldNotes.first;
 
         if ( note != nullptr ) {
+            // store the last/original pitch that the note is synthesizing in the orgPitches list
+            // so we can return to the pitch (if it hasn't been noteOff'ed yet) on noteOff
+            if ( !note->portamento.orgPitches.contains( note->pitch )) {
+                addToPitchHistory( note, note->pitch );
+            }
+            setPitch( note, pitch ); // update "ownership" of note by adjusting pitch
+
             float targetFrequency = MIDITable::frequencies[ pitch ];
 
             note->portamento.enabled   = true;
             note->portamento.steps     = Igorski::Calc::millisecondsToBuffer( 1000.f * props.glide );
-            note->portamento.increment = ( targetFrequency - note->frequency ) / note->portamento.steps;
+            note->portamento.increment = log2f( targetFrequency / note->frequency ) / std::max( 1, note->portamento.steps );
 
             return;
         }
@@ -110,13 +129,24 @@ void Synthesizer::noteOn( int16 pitch, float normalizedVelocity, float tuning )
         tuningDelta = Calc::pitchShiftFactor( tuning / 100.f );
     }
 
-    note = new Note();
+    // make room when the maximum amount of voices is playing
+
+    while ( voiceQueue.getSize() >= maxVoices ) {
+        stealVoice();
+    }
+
+    note = voicePool.acquire();
+
+    if ( note == nullptr ) {
+        return; // all voices are in use
+    }
 
     note->id             = generateNextNoteId();
-    note->pitch          = pitch;
+    note->pitch          = -1;
     note->volume         = normalizedVelocity;
     note->released       = false;
-    note->muted          = false;
+    note->stolen         = false;
+    note->order          = ++noteOrder;
     note->baseFrequency  = MIDITable::frequencies[ pitch ] * tuningDelta;
     note->frequency      = note->baseFrequency;
     note->phase          = 0.f;
@@ -124,10 +154,16 @@ void Synthesizer::noteOn( int16 pitch, float normalizedVelocity, float tuning )
     note->arpIndex       = 0;
     note->arpOffset      = 0;
 
-    notes.push_back( note );
-    handleNoteAmountChange();
+    note->filterState[ 0 ] = 0.f;
+    note->filterState[ 1 ] = 0.f;
+
+    setPitch( note, pitch );
+    notes.add( note );
+    heldNotes.add( note );
+    arpeggiatedNotes.add( note );
+    arpeggioChanged = true;
 
-    if ( doArpeggiate ) {
+    if ( doArpeggiate() ) {
         int fullMeasure   = round((( float ) SAMPLE_RATE * 60.f ) / TEMPO );
         ARPEGGIO_DURATION = fullMeasure / getArpeggiatorSpeedByTempo( TEMPO );
     }
@@ -147,6 +183,8 @@ void Synthesizer::noteOn( int16 pitch, float normalizedVelocity, float tuning )
     note->adsr.decayIncrement = ( 1.0f - note->adsr.sustain ) / std::max( 1.0f, note->adsr.decayDuration );
 
     // release is only set on noteOff (so the last known release is used if it is updated during Note playback)
+
+    voiceQueue.add( note, getStealPriority( note ));
 }
 
 void Synthesizer::noteOff( int16 pitch )
@@ -154,15 +192,10 @@ void Synthesizer::noteOff( int16 pitch )
     Note* note = getExistingNote( pitch );
 
     if ( doGlide() ) {
-        for ( Note* compareNote : notes ) {
-            auto pitchList = &compareNote->portamento.orgPitches;
-            // remove pitch from other playing notes pitch history
-            if ( std::find( pitchList->begin(), pitchList->end(), pitch ) != pitchList->end()) {
-                pitchList->erase( std::find( pitchList->begin(), pitchList->end(), pitch ));
-            }
-        }
+        // remove pitch from other playing notes pitch history
+        removeFromPitchHistory( pitch );
 
-        if ( note != nullptr && restorePitchOnRelease( note )) {
+        if ( note != nullptr && !note->stolen && restorePitchOnRelease( note )) {
             return; // pitch is restored on existing note, keep note in list
         }
     }
@@ -171,6 +204,10 @@ void Synthesizer::noteOff( int16 pitch )
         return; // likely first note in a portamento sequence (Note has changed "pitch ownership")
     }
 
+    if ( note->stolen ) {
+        return; // already fading out (see stealVoice())
+    }
+
     // instant removal when release is at 0 or note's sustain level is at 0
 
     if ( props.release == 0 || note->adsr.sustain == 0 ) {
@@ -188,114 +225,674 @@ void Synthesizer::noteOff( int16 pitch )
 
         note->released = true;
 
-        // if the SID was arpeggiating, update the note amount
-        // accordingly to toggle the proper arpeggiation state
+        // if the SID was arpeggiating, the released note moves to the end of the
+        // arpeggiated sequence (where it remains until its release phase has completed)
 
-        if ( doArpeggiate ) {
-            arpeggiatedNotes.erase( std::find( arpeggiatedNotes.begin(), arpeggiatedNotes.end(), note->id ));
-            handleNoteAmountChange();
+        if ( doArpeggiate() ) {
+            arpeggiatedNotes.remove( note );
+            arpeggiatedNotes.add( note );
+            arpeggioChanged = true;
         }
+        heldNotes.remove( note );
+
+        voiceQueue.update( note, getStealPriority( note ));
     }
 }
 
-Note* Synthesizer::getExistingNote( int16 pitch )
+void Synthesizer::removeNote( Note* note )
 {
-    for ( int32 i = 0; i < notes.size(); ++i ) {
-        if ( notes.at( i )->pitch == pitch ) {
-            return notes.at( i );
+    if ( !note->released ) {
+        heldNotes.remove( note );
+    }
+    if ( note->stolen ) {
+        stolenNotes.remove( note );
+    } else {
+        voiceQueue.remove( note );
+    }
+    notes.remove( note );
+    arpeggiatedNotes.remove( note );
+    arpeggioChanged = true;
+
+    // clear the lookups referencing this note
+
+    if ( notesByPitch[ note->pitch ] == note ) {
+        notesByPitch[ note->pitch ] = nullptr;
+    }
+    auto history = &note->portamento.orgPitches;
+    for ( int i = 0; i < history->size; ++i ) {
+        if ( pitchHistoryOwners[ history->pitches[ i ]] == note ) {
+            pitchHistoryOwners[ history->pitches[ i ]] = nullptr;
         }
     }
-    return nullptr;
+
+    // and lastly, return the Note to the pool
+    voicePool.release( note );
 }
 
-Note* Synthesizer::getNoteById( int32 id )
+void Synthesizer::reset()
 {
-    for ( int32 i = 0; i < notes.size(); ++i ) {
-        if ( notes.at( i )->id == id )
-            return notes.at( i );
+    while ( notes.first != nullptr ) {
+        removeNote( notes.first );
     }
-    return nullptr;
+    note_ids = 0;
 }
 
-bool Synthesizer::removeNote( Note* note )
+void Synthesizer::stealVoice()
 {
-    bool removed = false;
+    Note* note = voiceQueue.first();
 
-    // first remove from arpeggiated notes vector
+    // the level at which the Note continues (e.g. the gain of its next envelope sample)
 
-    if ( isArpeggiatedNote( note )) {
-       arpeggiatedNotes.erase( std::find( arpeggiatedNotes.begin(), arpeggiatedNotes.end(), note->id ));
+    float level = Envelope::getRamp( note->adsr, note->released ).value;
+
+    if ( level <= 0.f ) {
+        removeNote( note ); // silent, can be removed right away
+        return;
     }
 
-    // and lastly, remove from notes vector and free memory
+    // the amount of simultaneously fading Notes is limited, the Note
+    // that has been fading out the longest is removed instantly
 
-    if ( std::find( notes.begin(), notes.end(), note ) != notes.end()) {
-        notes.erase( std::find( notes.begin(), notes.end(), note ));
-        handleNoteAmountChange();
-        delete note;
-        removed = true;
+    if ( stolenNotes.size >= MAX_STOLEN_VOICES ) {
+        removeNote( stolenNotes.first );
+    }
+    voiceQueue.remove( note );
+
+    if ( !note->released ) {
+        // as with a noteOff, the Note moves to the end of the arpeggiated sequence
+        if ( doArpeggiate() ) {
+            arpeggiatedNotes.remove( note );
+            arpeggiatedNotes.add( note );
+            arpeggioChanged = true;
+        }
+        heldNotes.remove( note );
     }
-    return removed;
+
+    // fade out from the current level by releasing the Note over a short duration
+
+    float fadeSamples = std::max( 1.f, STEAL_FADE_DURATION * ( float ) SAMPLE_RATE );
+
+    note->adsr.release          = STEAL_FADE_DURATION;
+    note->adsr.releaseValue     = note->adsr.sustain - level;
+    note->adsr.releaseIncrement = level / fadeSamples;
+
+    note->released = true;
+    note->stolen   = true;
+
+    stolenNotes.add( note );
 }
 
-void Synthesizer::reset()
+double Synthesizer::getStealPriority( Note* note )
+{
+    switch ( voiceStealing )
+    {
+        default:
+        case VoiceStealing::RELEASED_FIRST:
+            // released Notes precede all held Notes, either group is ordered by age
+            return ( double ) note->order + ( note->released ? 0.0 : 4294967296.0 );
+
+        case VoiceStealing::OLDEST:
+            return ( double ) note->order;
+
+        case VoiceStealing::QUIETEST:
+        {
+            Envelope::Ramp ramp = Envelope::getRamp( note->adsr, note->released );
+
+            // Notes are considered at full level during their attack (as otherwise
+            // the most recently played Note would always be the quietest)
+
+            float level = ( ramp.stage == Envelope::Stages::ATTACK ) ? 1.f : ramp.value;
+            return ( double ) ( level * note->volume );
+        }
+    }
+}
+
+void Synthesizer::updateStealPriorities()
 {
-    while ( notes.size() > 0 ) {
-        removeNote( notes.at( 0 ));
+    for ( Note* note = notes.first; note != nullptr; note = note->link.next ) {
+        if ( !note->stolen ) {
+            voiceQueue.update( note, getStealPriority( note ));
+        }
     }
-    arpeggiatedNotes.clear();
-    note_ids = 0;
 }
 
-void Synthesizer::handleNoteAmountChange()
+int Synthesizer::gatherVoices( Note* arpeggiatedNote, int bufferSize )
 {
-    int amountOfNotes = notes.size();
-    int activeNotes   = 0;
+    voiceBank.clear();
+    pendingRemovals.clear();
 
-    int32 i;
+    int arpeggiatedLane = -1;
 
-    for ( i = 0; i < amountOfNotes; ++i )
+    // reverse loop as we might splice notes while gathering
+    Note* previousNote;
+    for ( Note* note = notes.last; note != nullptr; note = previousNote )
     {
-        if ( !notes.at( i )->released )
-            ++activeNotes;
+        previousNote = note->link.previous;
+
+        // is note muted (e.g. is the amount of notes above the arpeggio threshold) ?
+
+        if ( arpeggiatedNote != nullptr && note != arpeggiatedNote ) {
+            if ( note->adsr.release > 0.f && note->released ) {
+                // if note is released, increments it release value, if the resulting
+                // envelope is silent, remove the note. Notes preceding the arpeggiated note
+                // are only removed after rendering, as the arpeggiator should still
+                // cycle through their frequencies during this iteration
+                note->adsr.releaseValue += ( note->adsr.releaseIncrement * bufferSize );
+                if ( note->adsr.sustain - note->adsr.releaseValue < 0.f ) {
+                    if ( arpeggiatedLane == -1 ) {
+                        removeNote( note );
+                    } else {
+                        pendingRemovals.push_back( note );
+                    }
+                }
+            }
+            continue;
+        }
+        int lane = voiceBank.add( note, note->portamento.enabled && note->portamento.steps > 0 );
+
+        if ( note == arpeggiatedNote ) {
+            arpeggiatedLane = lane;
+        }
     }
-    // we only arpeggiate when the current amount of unreleased
-    // notes meets or exceeds the arpeggiator threshold
-    // (released notes should not arpeggiate)
+    return arpeggiatedLane;
+}
 
-    doArpeggiate = activeNotes >= ARPEGGIATOR_THRESHOLD;
+void Synthesizer::renderVoices( int waveform, int offset, int length )
+{
+    using namespace SIMD;
 
-    for ( i = 0; i < amountOfNotes; ++i )
+    float* mix = voiceBank.mix;
+
+    int voiceAmount = voiceBank.getSize();
+    int fullGroups  = voiceAmount / LANES;
+
+    // when filtering per voice, the output of each group (or single voice) is filtered before it
+    // is mixed (except for the first, which is filtered in place), the swept cutoff is shared by all
+
+    bool filtered = voiceFilter != nullptr;
+
+    if ( filtered ) {
+        voiceFilter->sweepVoices( length );
+    }
+
+    // full groups of voices are rendered at once, the first group
+    // stores its output while subsequent groups add onto it
+
+    for ( int group = 0; group < fullGroups; ++group )
     {
-        Note* note = notes.at( i );
+        renderEnvelopes<float4>( group * LANES, length, voiceBank.gain );
+
+        if ( waveform == Waveforms::PWM ) {
+            renderPulseWidths<float4>( offset, length, voiceBank.pwm[ group ], voiceBank.pulseWidth );
+        }
+        float4* groupOutput = ( filtered && group > 0 ) ? voiceBank.voiceOutput : voiceBank.output;
+
+        renderOscillators<float4>(
+            waveform, length, voiceBank.phase[ group ], voiceBank.frequency[ group ], voiceBank.portamentoSteps[ group ],
+            voiceBank.portamentoIncrement[ group ], voiceBank.volume[ group ], voiceBank.gain, voiceBank.pulseWidth,
+            groupOutput, group > 0 && !filtered
+        );
+
+        if ( filtered ) {
+            voiceFilter->processVoices<float4>(
+                groupOutput, length, voiceBank.filterState1[ group ], voiceBank.filterState2[ group ], voiceBank.gain
+            );
+            if ( group > 0 ) {
+                for ( int32 i = 0; i < length; ++i ) {
+                    voiceBank.output[ i ] = voiceBank.output[ i ] + groupOutput[ i ];
+                }
+            }
+        }
+    }
+
+    bool mixed = fullGroups > 0;
+
+    if ( mixed ) {
+        for ( int32 i = 0; i < length; ++i ) {
+            mix[ i ] = sum( voiceBank.output[ i ]);
+        }
+    }
 
-        // when arpeggiated, we impose a limit on audible notes as we will use
-        // a pitch cycle in the render function to play the muted notes frequency
-        // once the arpeggiator step shifts to the next step
+    // the remaining voices are rendered individually (a partially filled group
+    // would spend the same time as a full one, which is slower for a single voice)
+    // where the first rendered voice stores its output instead of adding onto a cleared mix
 
-        bool audible = !doArpeggiate;
-        note->muted  = !audible;
+    float* gains       = reinterpret_cast<float*>( voiceBank.gain );
+    float* pulseWidths = reinterpret_cast<float*>( voiceBank.pulseWidth );
+    float* voiceOutput = reinterpret_cast<float*>( voiceBank.voiceOutput );
 
-        // when arpeggiating, add note to arpeggiated notes vector
+    for ( int index = fullGroups * LANES; index < voiceAmount; ++index )
+    {
+        if ( voiceBank.disposed[ index ]) {
+            continue; // release completed in a previous segment
+        }
+        renderEnvelopes<float>( index, length, gains );
 
-        if ( doArpeggiate && !isArpeggiatedNote( note )) {
-            arpeggiatedNotes.push_back( note->id );
+        if ( waveform == Waveforms::PWM ) {
+            renderPulseWidths<float>( offset, length, VoiceBank::lane( voiceBank.pwm, index ), pulseWidths );
+        }
+        float* output = ( filtered && mixed ) ? voiceOutput : mix;
+
+        renderOscillators<float>(
+            waveform, length, VoiceBank::lane( voiceBank.phase, index ), VoiceBank::lane( voiceBank.frequency, index ),
+            VoiceBank::lane( voiceBank.portamentoSteps, index ), VoiceBank::lane( voiceBank.portamentoIncrement, index ),
+            VoiceBank::lane( voiceBank.volume, index ), gains, pulseWidths, output, mixed && !filtered
+        );
+
+        if ( filtered ) {
+            voiceFilter->processVoices<float>(
+                output, length, VoiceBank::lane( voiceBank.filterState1, index ), VoiceBank::lane( voiceBank.filterState2, index ), gains
+            );
+            if ( mixed ) {
+                for ( int32 i = 0; i < length; ++i ) {
+                    mix[ i ] += output[ i ];
+                }
+            }
         }
+        mixed = true;
     }
 
-    if ( !doArpeggiate )
-        return;
+    if ( !mixed ) {
+        memset( mix, 0, length * sizeof( float )); // all remaining voices completed their release
+    }
+
+    // a change of the pitch bend has been interpolated by all voices
+    pitchBend = props.pitchBend;
+}
+
+template <typename Vector>
+void Synthesizer::renderEnvelopes( int index, int length, Vector* gains )
+{
+    const int voices = sizeof( Vector ) / sizeof( float );
+
+    Envelope::Ramp ramps[ voices ];
+    alignas( 16 ) float values[ voices ];
+    alignas( 16 ) float increments[ voices ];
+
+    for ( int v = 0; v < voices; ++v ) {
+        Note* note = voiceBank.voices[ index + v ];
+        ramps[ v ] = Envelope::getRamp( note->adsr, note->released );
+    }
+
+    // the envelopes are written in segments for which none of the voices changes stage
+
+    for ( int32 i = 0; i < length; )
+    {
+        int32 segmentLength = length - i;
 
-    for ( i = 0; i < amountOfNotes; ++i ) {
+        for ( int v = 0; v < voices; ++v ) {
+            segmentLength = std::min( segmentLength, ramps[ v ].length );
+            values[ v ]     = ramps[ v ].value;
+            increments[ v ] = ramps[ v ].increment;
+        }
+
+        Vector value     = SIMD::load<Vector>( values );
+        Vector increment = SIMD::load<Vector>( increments );
+        Vector position  = 0.f;
+        Vector* output   = gains + i;
+
+        for ( int32 j = 0; j < segmentLength; ++j ) {
+            output[ j ] = value + increment * position;
+            position    = position + 1.f;
+        }
+
+        for ( int v = 0; v < voices; ++v ) {
+            Note* note = voiceBank.voices[ index + v ];
+            Envelope::advance( note->adsr, ramps[ v ], note->released, segmentLength );
+        }
+        i += segmentLength;
+    }
+
+    // voices whose release has completed are disposed after rendering
+
+    for ( int v = 0; v < voices; ++v ) {
+        if ( ramps[ v ].stage == Envelope::Stages::COMPLETE ) {
+            voiceBank.disposed[ index + v ] = true;
+        }
+    }
+}
+
+template <typename Vector>
+void Synthesizer::renderPulseWidths( int offset, int length, Vector& pwm, Vector* pulseWidths )
+{
+    const int voices = sizeof( Vector ) / sizeof( float );
+
+    // the modulation is a slow moving sine whose position advances by two for each sample
+    // (the position within the buffer and the voices' running counter), it is
+    // only calculated at control rate and interpolated linearly in between
+
+    auto getPulseWidth = [ this, offset, &pwm ]( int32 i ) -> Vector {
+        alignas( 16 ) float values[ voices ];
+        SIMD::store( values, pwm + Vector(( float ) ( offset + i + i + 1 )));
+
+        for ( int v = 0; v < voices; ++v ) {
+            values[ v ] = PI - sinf( values[ v ] / ( float ) 0x4800 ) * PWR;
+        }
+        return SIMD::load<Vector>( values );
+    };
+
+    Vector start = getPulseWidth( 0 );
 
-        // when arpeggiating we'd like the first
-        // unreleased note to be unmuted as it will
-        // be the note to cycle through all frequencies
+    for ( int32 i = 0; i < length; )
+    {
+        int32 segmentLength = std::min( CONTROL_RATE, length - i );
 
-        if ( !notes.at( i )->released ) {
-            notes.at( i )->muted = false;
-            break;
+        Vector end       = getPulseWidth( i + segmentLength );
+        Vector increment = ( end - start ) / Vector(( float ) segmentLength );
+        Vector position  = 0.f;
+        Vector* output   = pulseWidths + i;
+
+        for ( int32 j = 0; j < segmentLength; ++j ) {
+            output[ j ] = start + increment * position;
+            position    = position + 1.f;
         }
+        start = end;
+        i    += segmentLength;
+    }
+    pwm = pwm + Vector(( float ) length );
+}
+
+template <typename Vector>
+Vector Synthesizer::modulatePhaseIncrement( int waveform, int length, Vector& frequency, Vector& steps, Vector glide )
+{
+    const int voices = sizeof( Vector ) / sizeof( float );
+
+    // the glides advance exponentially (e.g. linearly in pitch)
+
+    alignas( 16 ) float frequencies[ voices ];
+    alignas( 16 ) float remainingSteps[ voices ];
+    alignas( 16 ) float octaves[ voices ];
+
+    SIMD::store( frequencies, frequency );
+    SIMD::store( remainingSteps, steps );
+    SIMD::store( octaves, glide );
+
+    for ( int v = 0; v < voices; ++v ) {
+        if ( remainingSteps[ v ] > 0.f ) {
+            float glideSteps = std::min( remainingSteps[ v ], ( float ) length );
+            frequencies[ v ]    *= exp2f( octaves[ v ] * glideSteps );
+            remainingSteps[ v ] -= glideSteps;
+        }
+    }
+    frequency = SIMD::load<Vector>( frequencies );
+    steps     = SIMD::load<Vector>( remainingSteps );
+
+    return getPhaseIncrement( waveform, frequency, props.pitchBend );
+}
+
+template <typename Vector>
+void Synthesizer::renderOscillators( int waveform, int length, Vector& phase, Vector& frequency, Vector& steps,
+                                     Vector glide, Vector volume, const Vector* gains, const Vector* pulseWidths,
+                                     Vector* output, bool addToOutput )
+{
+    using Kernel = void ( Synthesizer::* )( int, Vector&, Vector&, Vector&, Vector, Vector, const Vector*, const Vector*, Vector* );
+
+    // the kernels for each configuration, indexed by waveform, modulated, bandLimited and addToOutput (in bits)
+
+    static const Kernel kernels[] = {
+        &Synthesizer::renderOscillatorKernel<Vector, Waveforms::TRIANGLE, false, false, false>,
+        &Synthesizer::renderOscillatorKernel<Vector, Waveforms::TRIANGLE, false, false, true>,
+        &Synthesizer::renderOscillatorKernel<Vector, Waveforms::TRIANGLE, false, true,  false>,
+        &Synthesizer::renderOscillatorKernel<Vector, Waveforms::TRIANGLE, false, true,  true>,
+        &Synthesizer::renderOscillatorKernel<Vector, Waveforms::TRIANGLE, true,  false, false>,
+        &Synthesizer::renderOscillatorKernel<Vector, Waveforms::TRIANGLE, true,  false, true>,
+        &Synthesizer::renderOscillatorKernel<Vector, Waveforms::TRIANGLE, true,  true,  false>,
+        &Synthesizer::renderOscillatorKernel<Vector, Waveforms::TRIANGLE, true,  true,  true>,
+        &Synthesizer::renderOscillatorKernel<Vector, Waveforms::PWM,      false, false, false>,
+        &Synthesizer::renderOscillatorKernel<Vector, Waveforms::PWM,      false, false, true>,
+        &Synthesizer::renderOscillatorKernel<Vector, Waveforms::PWM,      false, true,  false>,
+        &Synthesizer::renderOscillatorKernel<Vector, Waveforms::PWM,      false, true,  true>,
+        &Synthesizer::renderOscillatorKernel<Vector, Waveforms::PWM,      true,  false, false>,
+        &Synthesizer::renderOscillatorKernel<Vector, Waveforms::PWM,      true,  false, true>,
+        &Synthesizer::renderOscillatorKernel<Vector, Waveforms::PWM,      true,  true,  false>,
+        &Synthesizer::renderOscillatorKernel<Vector, Waveforms::PWM,      true,  true,  true>
+    };
+
+    // the phase increment only changes while a voice is gliding or the pitch bend is changing
+
+    bool modulated = SIMD::sum( steps ) > 0.f || pitchBend != props.pitchBend;
+
+    int configuration = ( waveform == Waveforms::PWM ? 8 : 0 ) + ( modulated ? 4 : 0 ) + ( bandLimited ? 2 : 0 ) + ( addToOutput ? 1 : 0 );
+
+    ( this->*kernels[ configuration ])( length, phase, frequency, steps, glide, volume, gains, pulseWidths, output );
+}
+
+template <typename Vector, int waveform, bool modulated, bool bandLimited, bool addToOutput>
+void Synthesizer::renderOscillatorKernel( int length, Vector& phase, Vector& frequency, Vector& steps,
+                                          Vector glide, Vector volume, const Vector* gains, const Vector* pulseWidths,
+                                          Vector* output )
+{
+    using namespace SIMD;
+
+    const Vector zero( 0.f );
+    const Vector one( 1.f );
+
+    // when modulated, the phase increment is calculated at the end of each control period and ramped towards
+    // in between (as is the inverse of the increment used to band-limit the discontinuities), otherwise
+    // the entire range is rendered as a single period with a constant increment
+
+    Vector phaseIncrement = getPhaseIncrement( waveform, frequency, modulated ? pitchBend : props.pitchBend );
+    Vector incrementStep        = zero;
+    Vector inverseIncrementStep = zero;
+
+    if constexpr ( waveform == Waveforms::TRIANGLE )
+    {
+        const Vector half( .5f );
+        const Vector four( 4.f );
+        const Vector three( 3.f );
+        const Vector two( 2.f );
+        const Vector eight( 8.f );
+
+        // the waveform has a corner twice per period (where its slope jumps from -4 to 4)
+
+        Vector cornerIncrement        = phaseIncrement * two;
+        Vector inverseCornerIncrement = one / cornerIncrement;
+
+        for ( int32 i = 0; i < length; )
+        {
+            int32 periodEnd = length;
+            Vector target   = phaseIncrement;
+
+            if constexpr ( modulated ) {
+                int32 periodLength = std::min( CONTROL_RATE, length - i );
+                Vector inversePeriodLength( 1.f / ( float ) periodLength );
+
+                periodEnd     = i + periodLength;
+                target        = modulatePhaseIncrement( waveform, periodLength, frequency, steps, glide );
+                incrementStep = ( target - phaseIncrement ) * inversePeriodLength;
+
+                if constexpr ( bandLimited ) {
+                    inverseIncrementStep = ( one / ( target * two ) - inverseCornerIncrement ) * inversePeriodLength;
+                }
+            }
+
+            for ( ; i < periodEnd; ++i )
+            {
+                // 0 == triangle (a parabola mirrored into the positive range)
+                auto rising = lessThan( phase, half );
+                Vector tmp  = phase * four - select( rising, one, three );
+                Vector amp  = abs( select( rising, one - tmp * tmp, tmp * tmp - one ));
+
+                if constexpr ( bandLimited ) {
+                    Vector position = phase * two - select( rising, zero, one );
+                    amp = amp + ( eight * cornerIncrement ) * PolyBLEP::ramp( position, cornerIncrement, inverseCornerIncrement );
+                }
+
+                // keep phase within range
+                phase = phase + phaseIncrement;
+                phase = select( greaterThan( phase, one ), phase - one, phase );
+
+                if constexpr ( modulated ) {
+                    phaseIncrement = phaseIncrement + incrementStep;
+
+                    if constexpr ( bandLimited ) {
+                        cornerIncrement        = phaseIncrement * two;
+                        inverseCornerIncrement = inverseCornerIncrement + inverseIncrementStep;
+                    }
+                }
+
+                amp = ( amp * gains[ i ]) * volume;
+
+                if constexpr ( addToOutput ) {
+                    output[ i ] = output[ i ] + amp;
+                } else {
+                    output[ i ] = amp;
+                }
+            }
+
+            if constexpr ( modulated ) {
+                // prevent accumulating rounding errors
+                phaseIncrement = target;
+
+                if constexpr ( bandLimited ) {
+                    cornerIncrement        = phaseIncrement * two;
+                    inverseCornerIncrement = one / cornerIncrement;
+                }
+            }
+        }
+    }
+    else
+    {
+        const Vector amplitude( PW_AMP * 4.f ); // make louder !
+        const Vector negativeAmplitude( -PW_AMP * 4.f );
+        const Vector twoPi( TWO_PI );
+        const Vector inverseTwoPi( 1.f / TWO_PI );
+
+        // the waveform has a rising edge at the start of its period and a falling
+        // edge at the pulse width, the edges are corrected in normalized phase
+
+        Vector edgeIncrement        = phaseIncrement * inverseTwoPi;
+        Vector inverseEdgeIncrement = one / edgeIncrement;
+
+        for ( int32 i = 0; i < length; )
+        {
+            int32 periodEnd = length;
+            Vector target   = phaseIncrement;
+
+            if constexpr ( modulated ) {
+                int32 periodLength = std::min( CONTROL_RATE, length - i );
+                Vector inversePeriodLength( 1.f / ( float ) periodLength );
+
+                periodEnd     = i + periodLength;
+                target        = modulatePhaseIncrement( waveform, periodLength, frequency, steps, glide );
+                incrementStep = ( target - phaseIncrement ) * inversePeriodLength;
+
+                if constexpr ( bandLimited ) {
+                    inverseIncrementStep = ( one / ( target * inverseTwoPi ) - inverseEdgeIncrement ) * inversePeriodLength;
+                }
+            }
+
+            for ( ; i < periodEnd; ++i )
+            {
+                // 1 == PWM
+                Vector amp = select( lessThan( phase, pulseWidths[ i ]), amplitude, negativeAmplitude );
+
+                if constexpr ( bandLimited ) {
+                    Vector rise = phase * inverseTwoPi;
+                    Vector fall = rise - pulseWidths[ i ] * inverseTwoPi;
+                    fall = select( lessThan( fall, zero ), fall + one, fall );
+
+                    amp = amp + amplitude * ( PolyBLEP::step( rise, edgeIncrement, inverseEdgeIncrement ) -
+                                              PolyBLEP::step( fall, edgeIncrement, inverseEdgeIncrement ));
+                }
+
+                phase = phase + phaseIncrement;
+                phase = select( greaterThan( phase, twoPi ), phase - twoPi, phase );
+
+                if constexpr ( modulated ) {
+                    phaseIncrement = phaseIncrement + incrementStep;
+
+                    if constexpr ( bandLimited ) {
+                        edgeIncrement        = phaseIncrement * inverseTwoPi;
+                        inverseEdgeIncrement = inverseEdgeIncrement + inverseIncrementStep;
+                    }
+                }
+
+                amp = ( amp * gains[ i ]) * volume;
+
+                if constexpr ( addToOutput ) {
+                    output[ i ] = output[ i ] + amp;
+                } else {
+                    output[ i ] = amp;
+                }
+            }
+
+            if constexpr ( modulated ) {
+                // prevent accumulating rounding errors
+                phaseIncrement = target;
+
+                if constexpr ( bandLimited ) {
+                    edgeIncrement        = phaseIncrement * inverseTwoPi;
+                    inverseEdgeIncrement = one / edgeIncrement;
+                }
+            }
+        }
+    }
+}
+
+void Synthesizer::commitVoices( Note* arpeggiatedNote, int bufferSize )
+{
+    for ( int index = 0; index < voiceBank.getSize(); ++index )
+    {
+        Note* note = voiceBank.voices[ index ];
+
+        if ( voiceBank.disposed[ index ]) {
+            removeNote( note );
+            continue;
+        }
+        note->phase     = VoiceBank::lane( voiceBank.phase, index );
+        note->frequency = VoiceBank::lane( voiceBank.frequency, index );
+        note->pwm       = VoiceBank::lane( voiceBank.pwm, index );
+
+        note->filterState[ 0 ] = VoiceBank::lane( voiceBank.filterState1, index );
+        note->filterState[ 1 ] = VoiceBank::lane( voiceBank.filterState2, index );
+
+        if ( note->portamento.enabled && note->portamento.steps > 0 ) {
+            note->portamento.steps = ( int ) VoiceBank::lane( voiceBank.portamentoSteps, index );
+        }
+        if ( note != arpeggiatedNote ) {
+            note->arpOffset = std::max( 0, note->arpOffset - bufferSize );
+        }
+    }
+
+    for ( Note* note : pendingRemovals ) {
+        removeNote( note );
+    }
+
+    // the order of the quietest Notes changes as their envelopes progress
+
+    if ( voiceStealing == VoiceStealing::QUIETEST ) {
+        updateStealPriorities();
+    }
+}
+
+void Synthesizer::setPitch( Note* note, int16 pitch )
+{
+    if ( note->pitch >= 0 && notesByPitch[ note->pitch ] == note ) {
+        notesByPitch[ note->pitch ] = nullptr;
+    }
+    note->pitch = pitch;
+    notesByPitch[ pitch ] = note;
+}
+
+void Synthesizer::addToPitchHistory( Note* note, int16 pitch )
+{
+    // a pitch is only kept in the history of a single note
+
+    if ( pitchHistoryOwners[ pitch ] != nullptr && pitchHistoryOwners[ pitch ] != note ) {
+        removeFromPitchHistory( pitch );
+    }
+    note->portamento.orgPitches.add( pitch );
+    pitchHistoryOwners[ pitch ] = note;
+}
+
+void Synthesizer::removeFromPitchHistory( int16 pitch )
+{
+    Note* owner = pitchHistoryOwners[ pitch ];
+
+    if ( owner != nullptr ) {
+        owner->portamento.orgPitches.remove( pitch );
+        pitchHistoryOwners[ pitch ] = nullptr;
     }
 }
 
@@ -311,37 +908,111 @@ void Synthesizer::updateProperties( float attack, float decay, float sustain, fl
     ringModulator->setRate( ringModRate );
 }
 
+void Synthesizer::rampRingModRate( float ringModRate, int samples )
+{
+    ringModulator->rampRate( ringModRate, samples );
+}
+
+void Synthesizer::completeRamps()
+{
+    ringModulator->completeRamp();
+}
+
 bool Synthesizer::restorePitchOnRelease( Note* note )
 {
-    if ( !note->portamento.enabled || note->portamento.orgPitches.size() == 0 ) {
+    if ( !note->portamento.enabled || note->portamento.orgPitches.size == 0 ) {
         return false;
     }
-    auto lastPitch = note->portamento.orgPitches.back();
+    auto lastPitch = note->portamento.orgPitches.last();
     float targetFrequency = MIDITable::frequencies[ lastPitch ];
 
-    note->pitch = lastPitch;
-    note->portamento.orgPitches.pop_back();
+    note->portamento.orgPitches.removeLast();
+    pitchHistoryOwners[ lastPitch ] = nullptr;
+    setPitch( note, lastPitch );
 
     note->portamento.steps     = Igorski::Calc::millisecondsToBuffer( 1000.f * props.glide );
-    note->portamento.increment = ( targetFrequency - note->frequency ) / note->portamento.steps;
+    note->portamento.increment = log2f( targetFrequency / note->frequency ) / std::max( 1, note->portamento.steps );
 
     return true;
 }
 
 float Synthesizer::getArpeggiatorFrequency( int index )
 {
-    if ( arpeggiatedNotes.size() == 0 ) {
+    if ( arpeggioChanged ) {
+        updateArpeggio();
+    }
+    if ( arpeggioLength == 0 ) {
         return 0.f;
     }
-    index = std::min( index, ( int ) ( arpeggiatedNotes.size() - 1 ));
+    return arpeggioFrequencies[ std::min( index, arpeggioLength - 1 )];
+}
 
-    for ( int32 i = index; i < arpeggiatedNotes.size(); ++i ) {
-        Note* note = getNoteById( arpeggiatedNotes.at( i ));
-        if ( note != nullptr ) {
-            return note->baseFrequency;
+void Synthesizer::updateArpeggio()
+{
+    arpeggioLength = 0;
+
+    for ( Note* note = arpeggiatedNotes.first; note != nullptr; note = note->arpLink.next ) {
+        arpeggioFrequencies[ arpeggioLength++ ] = note->baseFrequency;
+    }
+    arpeggioChanged = false;
+}
+
+int Synthesizer::getVoiceAmount()
+{
+    return notes.size;
+}
+
+int Synthesizer::getReleaseSamples()
+{
+    // a stolen Note fades out over a release of its own
+    return ( int ) ceil( MAX_ENVELOPE_SAMPLES * std::max( props.release, STEAL_FADE_DURATION ));
+}
+
+int Synthesizer::collectFlushedValues()
+{
+    return ringModulator->collectFlushedValues();
+}
+
+void Synthesizer::setBandLimited( bool value )
+{
+    bandLimited = value;
+}
+
+void Synthesizer::setMaxVoices( int amount )
+{
+    maxVoices = std::max( 1, std::min( amount, voicePool.getCapacity()));
+
+    // a reduced maximum is applied immediately
+
+    while ( voiceQueue.getSize() > maxVoices ) {
+        stealVoice();
+    }
+}
+
+void Synthesizer::setVoiceFilter( Filter* filter )
+{
+    if ( filter == voiceFilter ) {
+        return;
+    }
+
+    // the voices have not been filtered individually for a while (if ever), start from silence
+
+    if ( voiceFilter == nullptr ) {
+        for ( Note* note = notes.first; note != nullptr; note = note->link.next ) {
+            note->filterState[ 0 ] = 0.f;
+            note->filterState[ 1 ] = 0.f;
         }
     }
-    return getNoteById( arpeggiatedNotes.at( 0 ))->baseFrequency;
+    voiceFilter = filter;
+}
+
+void Synthesizer::setVoiceStealing( int policy )
+{
+    if ( policy == voiceStealing ) {
+        return;
+    }
+    voiceStealing = policy;
+    updateStealPriorities();
 }
 
 int Synthesizer::getArpeggiatorSpeedByTempo( float tempo )
@@ -380,9 +1051,4 @@ uint16 Synthesizer::generateNextNoteId()
     return id;
 }
 
-bool Synthesizer::isArpeggiatedNote( Note* note )
-{
-    return std::find( arpeggiatedNotes.begin(), arpeggiatedNotes.end(), note->id ) != arpeggiatedNotes.end();
-}
-
 }
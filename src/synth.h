@@ -24,106 +24,38 @@
 #define __SYNTHESIZER_HEADER__
 
 #include "global.h"
+#include "filter.h"
 #include "ringmod.h"
+#include "voicebank.h"
+#include "voicepool.h"
+#include "voicequeue.h"
+#include <math.h>
+#include <string.h>
 #include <vector>
 
 using namespace Steinberg;
 
 namespace Igorski {
 
-    // data type for a single Note
-
-    struct Note {
-        uint16 id;      // used internally to reference Notes
-        int16 pitch;    // provided by noteOn|Off events from host, used to map to playing Note
-        bool released;
-        bool muted;
-        float volume;
-        float baseFrequency; // frequency (in Hz) at noteOn
-        float frequency;     // current render frequency (can be shifted by arpeggiator!)
-        float phase;
-        float pwm;
-
-        // arpeggio specific
-        int arpOffset;
-        int arpIndex;
-        float* arpFreqs;
-
-        struct PORTAMENTO {
-            bool enabled;
-            int steps;          // amount of samples over which portamento is executed
-            float increment;    // pitch increment in Hz (per step)
-            std::vector<int16> orgPitches; // history of pitches played before latest note was synthesizd
-
-            PORTAMENTO() {
-                enabled   = false;
-                steps     = 0;
-                increment = 0.f;
-            }
-        };
-        PORTAMENTO portamento;
-
-        struct ADSR {
-            float attack;
-            float decay;
-            float sustain;
-            float release;
-            float envelope;
-            int maxLength;
-
-            // the "_length"-properties describe the total length (in buffer cycles)
-            // the envelope lasts for
-            // the "_step"-properties describe the current offset in the total attack
-            // envelope slope (relative to total slope length "attack_length")
-
-            float attackDuration;
-            float attackValue;
-            float attackIncrement;
-
-            float decayDuration;
-            float decayValue;
-            float decayIncrement;
-
-            float releaseDuration;
-            float releaseValue;
-            float releaseIncrement;
-
-            // data type for a Note's ADSR properties
-            // ADSR is applied per Note, note for the entirety of the
-            // instrument as VSTSID is awesome
-
-            ADSR() {
-                attack    = 0.0f;
-                decay     = 0.0f;
-                sustain   = 1.0f;
-                release   = 0.0f;
-                envelope  = 1.0f;
-                maxLength = 0;
-
-                attackDuration   = 0.f;
-                attackValue      = 0.f;
-                attackIncrement  = 0.f;
-                decayDuration    = 0.f;
-                decayValue       = 0.f;
-                decayIncrement   = 0.f;
-                releaseDuration  = 0.f;
-                releaseValue     = 0.f;
-                releaseIncrement = 0.f;
-            }
-        };
-        ADSR adsr;
-    };
-
     enum Waveforms
     {
         TRIANGLE,
         PWM
     };
 
+    // the Note that is stolen when a new Note is played while the maximum amount of voices is playing
+
+    enum VoiceStealing
+    {
+        RELEASED_FIRST, // the oldest released Note (or the oldest Note when none are released)
+        OLDEST,         // the Note that was played first
+        QUIETEST        // the Note with the lowest current envelope level
+    };
+
     class Synthesizer {
 
         public:
-            Synthesizer();
+            Synthesizer( int maxPolyphony = VST::MAX_POLYPHONY );
             ~Synthesizer();
 
             double TEMPO; // in BPM, taken from host
@@ -141,10 +73,48 @@ namespace Igorski {
                  float ringModRate, float pitchBend, float portamento
             );
 
+            // ramps the rate of the ring modulator (in 0 - 1 range) towards given rate over the
+            // next given amount of ring modulated samples (see RingModulator::rampRate())
+            void rampRingModRate( float ringModRate, int samples );
+            void completeRamps();
+
             // the whole point of this exercise: synthesizing sweet, sweet PWM !
+            // this is a mono synthesizer, rendering into a single channel buffer (the contents of
+            // which are overwritten). Returns false (leaving the buffer untouched) when no notes are playing
+            // blockOffset is the position of the buffer within the hosts block (when rendering it in parts)
+
+            template <typename SampleType>
+            bool synthesize( SampleType* outputBuffer, int bufferSize, int blockOffset = 0 );
+
+            // apply the ring modulator onto the synthesized output (separate from synthesize()
+            // so the cost of each stage can be measured individually)
 
             template <typename SampleType>
-            bool synthesize( SampleType** outputBuffers, int numChannels, int bufferSize, Steinberg::uint32 sampleFramesSize );
+            void ringModulate( SampleType* outputBuffer, int bufferSize );
+
+            // the amount of Notes currently registered for playback
+            int getVoiceAmount();
+
+            // the amount of samples a Note sounds after its noteOff
+            int getReleaseSamples();
+
+            // the amount of ring modulator state values flushed to zero since the last invocation
+            int collectFlushedValues();
+
+            // whether the discontinuities of the oscillators are band-limited (see polyblep.h),
+            // removing the aliasing of the waveforms at high pitches and low sample rates
+            void setBandLimited( bool value );
+
+            // the maximum amount of simultaneously playing Notes and the policy by which a playing
+            // Note is chosen to make room for a new Note once this amount is reached (see VoiceStealing)
+            void setMaxVoices( int amount );
+            void setVoiceStealing( int policy );
+
+            // filter each voice individually using the model of given Filter (which is then no longer to be applied
+            // onto the synthesized output), allowing the cutoff to follow the envelope of each voice. Voices are
+            // filtered a full group at a time (see VoiceBank). Pass nullptr to restore the unfiltered output
+            void setVoiceFilter( Filter* filter );
+            bool hasVoiceFilter() { return voiceFilter != nullptr; }
 
             // the amount of simultaneous notes at which arpeggiation begins
 
@@ -166,10 +136,44 @@ namespace Igorski {
 
             Steinberg::Vst::mda::RingModulator* ringModulator;
 
-            // collection of Notes registered for playback
+            // collection of Notes registered for playback (allocated from the pool),
+            // the subset of Notes that haven't been released yet (both in order of noteOn)
+            // and all Notes in the order in which they are cycled by the arpeggiator
+
+            VoicePool voicePool;
+            NoteList notes            = NoteList( &Note::link );
+            NoteList heldNotes        = NoteList( &Note::heldLink );
+            NoteList arpeggiatedNotes = NoteList( &Note::arpLink );
+
+            // base frequencies of the arpeggiated sequence as a contiguous ring, this is
+            // rebuilt on the first arpeggiator step following a change to the sequence
 
-            std::vector<Note*> notes;
-            std::vector<int>   arpeggiatedNotes;
+            std::vector<float> arpeggioFrequencies;
+            int arpeggioLength      = 0;
+            bool arpeggioChanged    = false;
+
+            // lookup of the Note playing each MIDI pitch and of the Note
+            // whose portamento pitch history contains each MIDI pitch
+
+            Note* notesByPitch[ 128 ];
+            Note* pitchHistoryOwners[ 128 ];
+
+            // oscillator state of the audible Notes during synthesize() and the muted Notes
+            // whose release completed but can only be removed once the arpeggiator has stepped
+
+            VoiceBank voiceBank;
+            std::vector<Note*> pendingRemovals;
+
+            // all Notes that can be stolen (in order of their stealing priority) and the stolen Notes that are
+            // fading out (in order of stealing, as stolen Notes are no longer held these share the held Notes link)
+
+            VoiceQueue voiceQueue;
+            NoteList stolenNotes = NoteList( &Note::heldLink );
+            int maxVoices;
+            int voiceStealing;
+            uint32 noteOrder;
+
+            Filter* voiceFilter = nullptr;
 
             // synthesis related properties
 
@@ -178,13 +182,38 @@ namespace Igorski {
             const float PWR    = PI / 1.05f;
             const float PW_AMP = 0.075f;
 
+            // interval (in samples) at which the pulse width modulation and the phase increments of the
+            // oscillators (which are modulated by portamento and pitch bend) are calculated, these are
+            // interpolated linearly in between
+            const int CONTROL_RATE = 32;
+
+            // the pitch bend that was applied at the end of the last rendered segment, a change
+            // of props.pitchBend is interpolated over the first control period of the next segment
+            float pitchBend;
+
+            bool bandLimited = false;
+
+            // the waveform the sounding Notes were last rendered with (see synthesize())
+            int renderedWaveform = Waveforms::PWM;
+
+            // duration (in seconds) of the fade out of a stolen Note (preventing clicks), at most MAX_STOLEN_VOICES
+            // Notes fade out simultaneously so the amount of rendered voices never exceeds maxVoices + MAX_STOLEN_VOICES
+            const float STEAL_FADE_DURATION = 0.005f;
+            const int MAX_STOLEN_VOICES     = 4;
+
             float TWO_PI_OVER_SR;
             int SAMPLE_RATE,     // in Hz, taken from host
                 BUFFER_SIZE,
                 MAX_ENVELOPE_SAMPLES,
                 ARPEGGIO_DURATION;
 
-            bool doArpeggiate = false;
+            // we only arpeggiate when the current amount of unreleased
+            // notes meets or exceeds the arpeggiator threshold
+            // (released notes should not arpeggiate)
+
+            inline bool doArpeggiate() {
+                return heldNotes.size >= ARPEGGIATOR_THRESHOLD;
+            }
 
             inline bool doGlide() {
                 return props.glide > 0.f;
@@ -192,27 +221,85 @@ namespace Igorski {
 
             // retrieves an existing Note for given arguments, if none
             // could be found, nullptr is returned
-            Note* getExistingNote( int16 pitch );
-            Note* getNoteById( int32 id );
+            inline Note* getExistingNote( int16 pitch ) {
+                return notesByPitch[ pitch ];
+            }
 
             // removes a Note from the list (used internally when
             // release phase has completed after "noteOff")
-            bool removeNote( Note* note );
+            void removeNote( Note* note );
 
             // removes all currently playing notes
             void reset();
 
-            // internal update routines used to determine whether the
-            // currently playing notes should play back in polyphony
-            // or as an arpeggiated sequence
+            // fades out the first Note of the voice queue to make room for a new Note
+            void stealVoice();
+
+            // the priority by which given Note is stolen (the lowest is stolen first) under the current policy
+            double getStealPriority( Note* note );
+            void updateStealPriorities();
+
+            // render routines for synthesize(): gather the audible Notes into the voice bank
+            // (returning the lane of given arpeggiated Note), render given range of samples
+            // for all gathered voices into the banks mix buffer (overwriting its contents) and commit the updated
+            // voice state back into the Notes (removing those that have completed their release)
+
+            int gatherVoices( Note* arpeggiatedNote, int bufferSize );
+            void renderVoices( int waveform, int offset, int length );
+            void commitVoices( Note* arpeggiatedNote, int bufferSize );
+
+            // writes the envelope gains of either a full group of voices (Vector is SIMD::float4)
+            // or a single voice (Vector is float) starting at given lane, for given range of samples
+            template <typename Vector>
+            void renderEnvelopes( int index, int length, Vector* gains );
+
+            // writes the pulse widths of either a full group of voices or a single voice
+            // for given range of samples, advancing their modulation counters
+            template <typename Vector>
+            void renderPulseWidths( int offset, int length, Vector& pwm, Vector* pulseWidths );
+
+            // advances the glides (by given amount of octaves per sample) of either a full group of voices or a
+            // single voice by given amount of samples, returning the phase increment at the end of the range
+            template <typename Vector>
+            Vector modulatePhaseIncrement( int waveform, int length, Vector& frequency, Vector& steps, Vector glide );
+
+            // the phase increment (per sample) of given frequency (in Hz) for given waveform
+            template <typename Vector>
+            inline Vector getPhaseIncrement( int waveform, Vector frequency, float bend ) {
+                if ( waveform == Waveforms::TRIANGLE ) {
+                    return ( frequency * Vector( bend )) / Vector(( float ) SAMPLE_RATE ); // in normalized phase
+                }
+                return Vector( TWO_PI_OVER_SR ) * ( frequency * Vector( bend )); // in radians
+            }
+
+            // renders the oscillators for either a full group of voices or a single voice,
+            // applying the gains and pulse widths rendered by the methods above
+            template <typename Vector>
+            void renderOscillators( int waveform, int length, Vector& phase, Vector& frequency, Vector& steps,
+                                    Vector glide, Vector volume, const Vector* gains, const Vector* pulseWidths,
+                                    Vector* output, bool addToOutput );
+
+            // the kernels selected by renderOscillators(), specialised for the waveform, whether the phase increment
+            // is modulated (by portamento or a change of pitch bend, in which case it is calculated at control rate
+            // and ramped in between), whether the discontinuities are band-limited and whether the output is added
+            // onto the existing output, so that no conditions remain to be evaluated for each sample
+            template <typename Vector, int waveform, bool modulated, bool bandLimited, bool addToOutput>
+            void renderOscillatorKernel( int length, Vector& phase, Vector& frequency, Vector& steps,
+                                         Vector glide, Vector volume, const Vector* gains, const Vector* pulseWidths,
+                                         Vector* output );
+
+            // internal update routines to keep the pitch lookups in sync
+
+            void setPitch( Note* note, int16 pitch );
+            void addToPitchHistory( Note* note, int16 pitch );
+            void removeFromPitchHistory( int16 pitch );
 
-            void handleNoteAmountChange();
             uint16 generateNextNoteId();
             uint16 note_ids;
             bool restorePitchOnRelease( Note* note );
 
             float getArpeggiatorFrequency( int index );
-            bool isArpeggiatedNote( Note* note );
+            void updateArpeggio();
 
             // get the appropriate arpeggiator speed for given tempo
             int getArpeggiatorSpeedByTempo( float tempo );
@@ -23,202 +23,89 @@
 namespace Igorski {
 
 template <typename SampleType>
-bool Synthesizer::synthesize( SampleType** outputBuffers, int numChannels, int bufferSize, uint32 sampleFramesSize )
+bool Synthesizer::synthesize( SampleType* outputBuffer, int bufferSize, int blockOffset )
 {
-    // clear existing output buffer contents
-    for ( int32 i = 0; i < numChannels; i++ ) {
-        memset( outputBuffers[ i ], 0, sampleFramesSize );
-    }
-
-    if ( notes.size() == 0 ) {
+    if ( notes.size == 0 ) {
+        pitchBend = props.pitchBend; // nothing to interpolate
         return false; // nothing to do
     }
-    SampleType pmv, dpw, amp, frequency, phase, envelope, tmp;
-
-    int voiceAmount = notes.size();
-    int arpIndex    = -1;
+    int voiceAmount = notes.size;
 
     // in case ring modulator is active, synthesize as a triangle
 
     int waveform = ( ringModulator->getRate() == 0.f ) ? Waveforms::PWM : Waveforms::TRIANGLE;
 
-    // reverse loop as we might splice notes during render
-    int32 j = notes.size();
-    while ( j-- )
-    {
-        Note* note = notes.at( j );
+    // the triangle runs in normalized phase while the pulse runs in radians, when the ring modulator is toggled
+    // mid-note the phase of all Notes is converted (instead of overshooting the range of the new waveform), this
+    // includes the Notes muted by the arpeggiator as these resume at their own phase once the arpeggio ends
 
-        bool doAttack  = note->adsr.attack  > 0.f;
-        bool doDecay   = note->adsr.decay   > 0.f && note->adsr.sustain != 1.f;
-        bool doRelease = note->adsr.release > 0.f && note->released;
+    if ( waveform != renderedWaveform ) {
+        float scale = ( waveform == Waveforms::TRIANGLE ) ? 1.f / TWO_PI : TWO_PI;
+        for ( Note* note = notes.first; note != nullptr; note = note->link.next ) {
+            note->phase *= scale;
+        }
+        renderedWaveform = waveform;
+    }
 
-        // is note muted (e.g. is the amount of notes above the arpeggio threshold) ?
+    // when arpeggiating, only the first unreleased note is audible as it
+    // cycles through the frequencies of all other (muted) notes
 
-        if ( note->muted ) {
-            if ( doRelease ) {
-                // if note is released, increments it release value, if the resulting
-                // envelope is silent, remove the note
-                note->adsr.releaseValue += ( note->adsr.releaseIncrement * bufferSize );
-                if ( note->adsr.sustain - note->adsr.releaseValue < 0.f ) {
-                    removeNote( note );
-                }
-            }
-            continue;
-        }
+    Note* arpeggiatedNote = doArpeggiate() ? heldNotes.first : nullptr;
+    int arpeggiatedLane   = gatherVoices( arpeggiatedNote, bufferSize );
 
-        bool portamento = note->portamento.enabled && note->portamento.steps > 0;
-        bool arpeggiate = !portamento && doArpeggiate && isArpeggiatedNote( note );
+    // a gliding note does not step through the arpeggio until its glide has completed
 
-        if ( arpIndex == -1 && arpeggiate ) {
-            arpIndex = note->arpIndex;
-        }
-        bool disposeNote = false;
+    bool arpeggiate = arpeggiatedNote != nullptr &&
+                      !( arpeggiatedNote->portamento.enabled && arpeggiatedNote->portamento.steps > 0 );
+    int arpIndex    = arpeggiate ? arpeggiatedNote->arpIndex : -1;
 
-        phase = note->phase;
+    // the buffer is rendered in segments, split at the arpeggiator steps
 
-        for ( int32 i = 0; i < bufferSize; ++i )
-        {
+    for ( int32 offset = 0, length = 0; offset < bufferSize; offset += length )
+    {
+        int32 segmentEnd = std::min( bufferSize, offset + VoiceBank::MAX_SEGMENT_SIZE );
+
+        if ( arpeggiate ) {
             // update note's frequency when arpeggiators offset
             // has exceeded the current length
 
-            if ( arpeggiate && note->arpOffset == 0 ) {
-
+            if ( arpeggiatedNote->arpOffset == 0 ) {
                 if ( ++arpIndex == voiceAmount ) {
                     arpIndex = 0;
                 }
-                note->frequency = getArpeggiatorFrequency( arpIndex );
-                note->arpOffset = ARPEGGIO_DURATION;
-
-                // WebSID had a maximum voice count, not sure why we'd want that actually =)
-//                    if ( voiceAmount > 4 )
-//                        break;
-            }
-
-            // synthesize waveform
-
-            if ( portamento ) {
-                note->frequency += note->portamento.increment;
-                if ( --note->portamento.steps == 0 ) {
-                    // glide completed, disable portamento for this render iteration
-                    portamento = false;
-                }
-            }
-            // apply global pitch bend onto note pitch
-            SampleType frequency = note->frequency * props.pitchBend;
-
-            switch ( waveform )
-            {
-                case Waveforms::TRIANGLE:
-                    // 0 == triangle
-                    if ( phase < .5f )
-                    {
-                        tmp = ( phase * 4.f - 1.f );
-                        amp = ( 1.f - tmp * tmp );
-                    }
-                    else {
-                        tmp = ( phase * 4.f - 3.f );
-                        amp = ( tmp * tmp - 1.f );
-                    }
-                    // the actual triangulation function
-                    amp = amp < 0 ? -amp : amp;
-
-                    phase += ( frequency / ( SampleType ) SAMPLE_RATE );
-
-                    // keep phase within range
-                    if ( phase > 1.f )
-                        phase -= 1.f;
-
-                    break;
-
-                case Waveforms::PWM:
-                    // 1 == PWM
-                    pmv   = i + ( ++note->pwm );
-                    dpw   = sinf( pmv / ( SampleType ) 0x4800 ) * PWR;
-                    amp   = phase < PI - dpw ? PW_AMP : -PW_AMP;
-                    phase = phase + ( TWO_PI_OVER_SR * frequency );
-                    phase = phase > TWO_PI ? phase - TWO_PI : phase;
-                    //am    = sinf( pmv / ( SampleType ) 0x1000 );
-
-                    amp *= 4.f; // make louder !
-                    break;
-            }
-
-            if ( note->arpOffset > 0 ) {
-                --note->arpOffset;
-            }
-
-            // apply envelopes
-
-            envelope = 1.f;
-
-            // release cancels all other phases (e.g. early noteOff before other phases have completed)
-
-            if ( doRelease ) {
-
-                envelope = note->adsr.sustain - note->adsr.releaseValue;
-
-                if ( envelope < 0.f ) {
-                    envelope = 0.f;
-                    disposeNote = true;
-                }
-                note->adsr.releaseValue += note->adsr.releaseIncrement;
-                amp *= envelope;
-            }
-            else {
-
-                // attack phase
-                if ( doAttack && note->adsr.attackValue < note->adsr.attack ) {
-
-                    note->adsr.envelope     = note->adsr.attackValue;
-                    note->adsr.attackValue += note->adsr.attackIncrement;
-
-                    amp *= note->adsr.envelope;
-                }
-                // decay phase
-                else if ( doDecay && note->adsr.envelope > note->adsr.sustain ) {
-
-                    note->adsr.envelope -= note->adsr.decayIncrement;
-                    amp *= note->adsr.envelope;
-                }
-                // sustain phase
-                else {
-                    amp *= note->adsr.sustain;
-                }
-            }
-
-            // write into output buffers
-            // this is (currently?) essentially a mono synth
-
-            for ( int32 c = 0; c < numChannels; ++c ) {
-                outputBuffers[ c ][ i ] += ( amp * note->volume );
-            }
-
-            // if note can be disposed, break this notes write loop
-
-            if ( disposeNote ) {
-                break;
+                VoiceBank::lane( voiceBank.frequency, arpeggiatedLane ) = getArpeggiatorFrequency( arpIndex );
+                arpeggiatedNote->arpOffset = std::max( 1, ARPEGGIO_DURATION );
             }
+            segmentEnd = std::min( segmentEnd, offset + arpeggiatedNote->arpOffset );
+            arpeggiatedNote->arpOffset -= ( segmentEnd - offset );
         }
+        length = segmentEnd - offset;
 
-        if ( disposeNote ) {
-            // remove note from the list
-            removeNote( note );
-        }
-        else {
-            // commit updated properties back into note
-            note->phase = phase;
+        renderVoices( waveform, blockOffset + offset, length );
 
-            if ( arpeggiate ) {
-                note->arpIndex = arpIndex;
-            }
+        // write into the output buffer, as each sample is written exactly
+        // once (all voices are mixed by the voice bank) it needs no clearing
+
+        SampleType* segmentBuffer = outputBuffer + offset;
+        for ( int32 i = 0; i < length; ++i ) {
+            segmentBuffer[ i ] = voiceBank.mix[ i ];
         }
     }
 
-    // ring modulation
+    // commit updated properties back into the notes
 
-    ringModulator->apply( outputBuffers, numChannels, bufferSize, sampleFramesSize );
+    if ( arpeggiate ) {
+        arpeggiatedNote->arpIndex = arpIndex;
+    }
+    commitVoices( arpeggiate ? arpeggiatedNote : nullptr, bufferSize );
 
     return true;
 }
 
+template <typename SampleType>
+void Synthesizer::ringModulate( SampleType* outputBuffer, int bufferSize )
+{
+    ringModulator->apply( outputBuffer, bufferSize );
+}
+
 } // E.O. namespace Igorski
\ No newline at end of file
@@ -162,6 +162,133 @@ tresult PLUGIN_API VSTSIDController::initialize( FUnknown* context )
         0, ParameterInfo::kCanAutomate, unitId
     ));
 
+    // Band-limited oscillators
+    parameters.addParameter(
+        STR16( "Band-limited oscillators" ), nullptr, 1, 0, ParameterInfo::kCanAutomate, kBandLimitedId
+    );
+
+    // Max voices
+    auto maxVoices = new RangeParameter(
+        STR16( "Max voices" ), kMaxVoicesId, USTRING( "voices" ),
+        1.f, ( float ) Igorski::VST::MAX_POLYPHONY, ( float ) Igorski::VST::MAX_POLYPHONY,
+        Igorski::VST::MAX_POLYPHONY - 1, ParameterInfo::kCanAutomate, unitId
+    );
+    maxVoices->setPrecision( 0 );
+    parameters.addParameter( maxVoices );
+
+    // Voice stealing (in order of the VoiceStealing enum)
+    auto voiceStealing = new StringListParameter(
+        STR16( "Voice stealing" ), kVoiceStealingId, nullptr,
+        ParameterInfo::kCanAutomate | ParameterInfo::kIsList, unitId
+    );
+    voiceStealing->appendString( STR16( "Released first" ));
+    voiceStealing->appendString( STR16( "Oldest" ));
+    voiceStealing->appendString( STR16( "Quietest" ));
+    parameters.addParameter( voiceStealing );
+
+    // Multi-timbral mode
+    parameters.addParameter(
+        STR16( "Multi-timbral" ), nullptr, 1, 0, ParameterInfo::kCanAutomate, kMultiTimbralId
+    );
+
+    // Filter mode (in order of the FilterModes enum)
+    auto filterMode = new StringListParameter(
+        STR16( "Filter mode" ), kFilterModeId, nullptr,
+        ParameterInfo::kCanAutomate | ParameterInfo::kIsList, unitId
+    );
+    filterMode->appendString( STR16( "Low-pass (biquad)" ));
+    filterMode->appendString( STR16( "Low-pass" ));
+    filterMode->appendString( STR16( "Band-pass" ));
+    filterMode->appendString( STR16( "High-pass" ));
+    parameters.addParameter( filterMode );
+
+    // Per-voice filter
+    parameters.addParameter(
+        STR16( "Per-voice filter" ), nullptr, 1, 0, ParameterInfo::kCanAutomate, kVoiceFilterId
+    );
+
+    // Filter envelope (applies to the per-voice filter)
+    parameters.addParameter( new RangeParameter(
+        USTRING( "Filter envelope" ), kFilterEnvelopeId, USTRING( "%" ),
+        0.f, 1.f, 0.f,
+        0, ParameterInfo::kCanAutomate, unitId
+    ));
+
+    // the sound parameters of the parts played by MIDI channels 2 - 16 in multi-timbral mode, these
+    // are copies of the parameters above (played by MIDI channel 1) within a unit for each part
+
+    for ( int part = 1; part < Igorski::VST::MAX_PARTS; ++part )
+    {
+        char name[ 128 ];
+        sprintf( name, "Part %d", part + 1 );
+
+        unitInfo.id = part + 1;
+        unitInfo.parentUnitId = kRootUnitId;
+        Steinberg::UString( unitInfo.name, USTRINGSIZE( unitInfo.name )).fromAscii( name );
+        unitInfo.programListId = kNoProgramListId;
+
+        addUnit( new Unit( unitInfo ));
+
+        for ( int p = 0; p < PART_PARAMETER_AMOUNT; ++p )
+        {
+            auto base = static_cast<RangeParameter*>( parameters.getParameter( PART_PARAMETERS[ p ]));
+            ParameterInfo info = base->getInfo();
+
+            char baseTitle[ 128 ];
+            char title[ 128 ];
+            Steinberg::UString( info.title, USTRINGSIZE( info.title )).toAscii( baseTitle, 128 );
+            snprintf( title, 128, "%s %s", name, baseTitle );
+
+            Steinberg::UString( info.title, USTRINGSIZE( info.title )).fromAscii( title );
+            info.id     = Igorski::VST::getPartParameterId( PART_PARAMETERS[ p ], part );
+            info.unitId = unitInfo.id;
+
+            auto param = new RangeParameter( info, base->getMin(), base->getMax());
+            param->setPrecision( base->getPrecision());
+            parameters.addParameter( param );
+        }
+    }
+
+    // DSP load meters (read-only, these are written by the processor)
+
+    struct Meter { const TChar* title; ParamID id; };
+    const Meter loadMeters[] = {
+        { STR16( "Synthesis load" ),      kSynthesisLoadId },
+        { STR16( "Synthesis min load" ),  kSynthesisMinId },
+        { STR16( "Synthesis peak load" ), kSynthesisPeakId },
+        { STR16( "Filter load" ),         kFilterLoadId },
+        { STR16( "Filter min load" ),     kFilterMinId },
+        { STR16( "Filter peak load" ),    kFilterPeakId },
+        { STR16( "Ring mod load" ),       kRingModLoadId },
+        { STR16( "Ring mod min load" ),   kRingModMinId },
+        { STR16( "Ring mod peak load" ),  kRingModPeakId },
+        { STR16( "Total load" ),          kTotalLoadId },
+        { STR16( "Total min load" ),      kTotalMinId },
+        { STR16( "Total peak load" ),     kTotalPeakId }
+    };
+    for ( const Meter& meter : loadMeters ) {
+        parameters.addParameter( new RangeParameter(
+            meter.title, meter.id, USTRING( "%" ),
+            0.f, Igorski::VST::MAX_METERED_LOAD, 0.f,
+            0, ParameterInfo::kIsReadOnly, unitId
+        ));
+    }
+
+    parameters.addParameter( new RangeParameter(
+        STR16( "Active voices" ), kActiveVoicesId, USTRING( "voices" ),
+        0.f, ( float ) Igorski::VST::MAX_METERED_VOICES, 0.f,
+        Igorski::VST::MAX_METERED_VOICES, ParameterInfo::kIsReadOnly, unitId
+    ));
+
+    // the amount of filter and ring modulator state values flushed to zero as these decayed towards
+    // the subnormal range (see Denormals::flush()), this does not count subnormal output samples
+
+    parameters.addParameter( new RangeParameter(
+        STR16( "Flushed state values" ), kFlushedValuesId, USTRING( "flushes" ),
+        0.f, ( float ) Igorski::VST::MAX_METERED_FLUSHES, 0.f,
+        0, ParameterInfo::kIsReadOnly, unitId
+    ));
+
     // Init Default MIDI-CC Map
 	std::for_each( midiCCMapping.begin(), midiCCMapping.end(), []( ParamID& pid ) {
         pid = InvalidParamID;
@@ -258,6 +385,50 @@ tresult PLUGIN_API VSTSIDController::setComponentState( IBStream* state )
         setParamNormalized( kPortamentoId, savedPortamento );
     }
 
+    int32 savedBandLimited = 0; // added after version 1.1.2
+    if ( streamer.readInt32( savedBandLimited ) != false ) {
+        setParamNormalized( kBandLimitedId, savedBandLimited ? 1 : 0 );
+    }
+
+    float savedMaxVoices = 1.f; // added after version 1.1.2
+    if ( streamer.readFloat( savedMaxVoices ) != false ) {
+        setParamNormalized( kMaxVoicesId, savedMaxVoices );
+    }
+
+    int32 savedVoiceStealing = 0; // added after version 1.1.2
+    if ( streamer.readInt32( savedVoiceStealing ) != false ) {
+        setParamNormalized( kVoiceStealingId, ( float ) savedVoiceStealing / ( Igorski::VST::VOICE_STEALING_POLICIES - 1 ));
+    }
+
+    int32 savedMultiTimbral = 0; // added after version 1.1.2, followed by the parameters of the other parts
+    if ( streamer.readInt32( savedMultiTimbral ) != false ) {
+        setParamNormalized( kMultiTimbralId, savedMultiTimbral ? 1 : 0 );
+
+        for ( int part = 1; part < Igorski::VST::MAX_PARTS; ++part ) {
+            for ( int p = 0; p < PART_PARAMETER_AMOUNT; ++p ) {
+                float savedValue = 0.f;
+                if ( streamer.readFloat( savedValue ) != false ) {
+                    setParamNormalized( Igorski::VST::getPartParameterId( PART_PARAMETERS[ p ], part ), savedValue );
+                }
+            }
+        }
+    }
+
+    int32 savedFilterMode = 0; // added after version 1.1.2
+    if ( streamer.readInt32( savedFilterMode ) != false ) {
+        setParamNormalized( kFilterModeId, ( float ) savedFilterMode / ( Igorski::VST::FILTER_MODES - 1 ));
+    }
+
+    int32 savedVoiceFilter = 0; // added after version 1.1.2
+    if ( streamer.readInt32( savedVoiceFilter ) != false ) {
+        setParamNormalized( kVoiceFilterId, savedVoiceFilter ? 1 : 0 );
+    }
+
+    float savedFilterEnvelope = 0.f; // added after version 1.1.2
+    if ( streamer.readFloat( savedFilterEnvelope ) != false ) {
+        setParamNormalized( kFilterEnvelopeId, savedFilterEnvelope );
+    }
+
     return kResultOk;
 }
 
@@ -351,7 +522,9 @@ tresult PLUGIN_API VSTSIDController::setParamNormalized( ParamID tag, ParamValue
 //------------------------------------------------------------------------
 tresult PLUGIN_API VSTSIDController::getParamStringByValue( ParamID tag, ParamValue valueNormalized, String128 string )
 {
-    switch ( tag )
+    // the parameters of the other parts are formatted as those of the first part
+
+    switch ( Igorski::VST::getBaseParameterId( tag ))
     {
         // ADSR envelopes and LFO depth are floating point values in 0 - 1 range, we can
         // simply read the normalized value which is in the same range
@@ -370,6 +543,7 @@ tresult PLUGIN_API VSTSIDController::getParamStringByValue( ParamID tag, ParamVa
         case kSustainId:
         case kLFODepthId:
         case kResonanceId:
+        case kFilterEnvelopeId:
         {
             char text[32];
             sprintf( text, "%.f pct", ( float ) valueNormalized * 100.f );
@@ -430,6 +604,37 @@ tresult PLUGIN_API VSTSIDController::getParamStringByValue( ParamID tag, ParamVa
             return kResultTrue;
         }
 
+        case kSynthesisLoadId:
+        case kSynthesisPeakId:
+        case kFilterLoadId:
+        case kFilterPeakId:
+        case kRingModLoadId:
+        case kRingModPeakId:
+        case kTotalLoadId:
+        case kTotalPeakId:
+        case kSynthesisMinId:
+        case kFilterMinId:
+        case kRingModMinId:
+        case kTotalMinId:
+        {
+            char text[32];
+            sprintf( text, "%.1f %%", normalizedParamToPlain( tag, valueNormalized ));
+            Steinberg::UString( string, 128 ).fromAscii( text );
+
+            return kResultTrue;
+        }
+
+        case kMaxVoicesId:
+        case kActiveVoicesId:
+        case kFlushedValuesId:
+        {
+            char text[32];
+            sprintf( text, "%.f", normalizedParamToPlain( tag, valueNormalized ));
+            Steinberg::UString( string, 128 ).fromAscii( text );
+
+            return kResultTrue;
+        }
+
         // everything else
         default:
             return EditControllerEx1::getParamStringByValue( tag, valueNormalized, string );
@@ -497,9 +702,11 @@ tresult PLUGIN_API VSTSIDController::queryInterface( const char* iid, void** obj
 tresult PLUGIN_API VSTSIDController::getMidiControllerAssignment( int32 busIndex, int16 channel,
     CtrlNumber midiControllerNumber, ParamID& id /*out*/)
 {
-    if ( busIndex == 0 && channel == 0 && midiControllerNumber < kCountCtrlNumber ) {
+    // in multi-timbral mode each MIDI channel controls the parameters of its own part
+
+    if ( busIndex == 0 && channel >= 0 && channel < Igorski::VST::MAX_PARTS && midiControllerNumber < kCountCtrlNumber ) {
 		if ( midiCCMapping[ midiControllerNumber ] != InvalidParamID ) {
-			id = midiCCMapping[ midiControllerNumber ];
+			id = Igorski::VST::getPartParameterId( midiCCMapping[ midiControllerNumber ], channel );
 			return kResultTrue;
 		}
 	}
@@ -0,0 +1,142 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "voicebank.h"
+
+namespace Igorski {
+
+VoiceBank::VoiceBank()
+{
+    phase               = nullptr;
+    frequency           = nullptr;
+    portamentoIncrement = nullptr;
+    portamentoSteps     = nullptr;
+    pwm                 = nullptr;
+    volume              = nullptr;
+    filterState1        = nullptr;
+    filterState2        = nullptr;
+    gain                = nullptr;
+    pulseWidth          = nullptr;
+    output              = nullptr;
+    mix                 = nullptr;
+    voiceOutput         = nullptr;
+    voices              = nullptr;
+    disposed            = nullptr;
+    size                = 0;
+    capacity            = 0;
+}
+
+VoiceBank::~VoiceBank()
+{
+    dispose();
+}
+
+void VoiceBank::init( int capacity )
+{
+    dispose();
+
+    int groups = ( capacity + SIMD::LANES - 1 ) / SIMD::LANES;
+
+    this->capacity = groups * SIMD::LANES;
+    size           = 0;
+
+    phase               = new SIMD::float4[ groups ];
+    frequency           = new SIMD::float4[ groups ];
+    portamentoIncrement = new SIMD::float4[ groups ];
+    portamentoSteps     = new SIMD::float4[ groups ];
+    pwm                 = new SIMD::float4[ groups ];
+    volume              = new SIMD::float4[ groups ];
+    filterState1        = new SIMD::float4[ groups ];
+    filterState2        = new SIMD::float4[ groups ];
+    gain                = new SIMD::float4[ MAX_SEGMENT_SIZE ];
+    pulseWidth          = new SIMD::float4[ MAX_SEGMENT_SIZE ];
+    output              = new SIMD::float4[ MAX_SEGMENT_SIZE ];
+    mix                 = new float[ MAX_SEGMENT_SIZE ];
+    voiceOutput         = new SIMD::float4[ MAX_SEGMENT_SIZE ];
+    voices              = new Note*[ this->capacity ];
+    disposed            = new bool[ this->capacity ];
+
+    // unused lanes of the last group are rendered alongside the used ones, as
+    // lanes are only written when a voice is added, zero everything upfront
+
+    for ( int i = 0; i < groups; ++i ) {
+        phase[ i ]               = 0.f;
+        frequency[ i ]           = 0.f;
+        portamentoIncrement[ i ] = 0.f;
+        portamentoSteps[ i ]     = 0.f;
+        pwm[ i ]                 = 0.f;
+        volume[ i ]              = 0.f;
+        filterState1[ i ]        = 0.f;
+        filterState2[ i ]        = 0.f;
+    }
+}
+
+void VoiceBank::clear()
+{
+    // silence the lanes that were in use so they do not contribute to the last group
+
+    for ( int i = 0; i < size; ++i ) {
+        lane( volume, i )          = 0.f;
+        lane( portamentoSteps, i ) = 0.f;
+    }
+    size = 0;
+}
+
+int VoiceBank::add( Note* note, bool portamento )
+{
+    int index = size++;
+
+    lane( phase, index )               = note->phase;
+    lane( frequency, index )           = note->frequency;
+    lane( portamentoIncrement, index ) = note->portamento.increment;
+    lane( portamentoSteps, index )     = portamento ? ( float ) note->portamento.steps : 0.f;
+    lane( pwm, index )                 = note->pwm;
+    lane( volume, index )              = note->volume;
+    lane( filterState1, index )        = note->filterState[ 0 ];
+    lane( filterState2, index )        = note->filterState[ 1 ];
+
+    voices[ index ]   = note;
+    disposed[ index ] = false;
+
+    return index;
+}
+
+void VoiceBank::dispose()
+{
+    delete[] phase;
+    delete[] frequency;
+    delete[] portamentoIncrement;
+    delete[] portamentoSteps;
+    delete[] pwm;
+    delete[] volume;
+    delete[] filterState1;
+    delete[] filterState2;
+    delete[] gain;
+    delete[] pulseWidth;
+    delete[] output;
+    delete[] mix;
+    delete[] voiceOutput;
+    delete[] voices;
+    delete[] disposed;
+}
+
+}
@@ -0,0 +1,110 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __VOICEBANK_HEADER__
+#define __VOICEBANK_HEADER__
+
+#include "note.h"
+#include "simd.h"
+
+namespace Igorski {
+
+    /**
+     * Structure-of-arrays copy of the oscillator state of all audible Notes, gathered
+     * at the start of each render iteration. Voices are stored in groups of SIMD::LANES
+     * so the Synthesizer can render a full group of voices per instruction. Allocation
+     * only takes place in init() (e.g. when processing is set up)
+     */
+    class VoiceBank {
+
+        public:
+            VoiceBank();
+            ~VoiceBank();
+
+            // the maximum amount of samples rendered in a single pass, longer
+            // buffers are rendered in multiple passes
+            static const int MAX_SEGMENT_SIZE = 256;
+
+            // (re)allocates the bank to hold given amount of voices
+            void init( int capacity );
+
+            // removes all gathered voices
+            void clear();
+
+            // copies the oscillator state of given Note into the next free lane and
+            // returns the lane index, the Note is not gliding when portamento is false
+            int add( Note* note, bool portamento );
+
+            int getSize()   { return size; }
+            int getGroups() { return ( size + SIMD::LANES - 1 ) / SIMD::LANES; }
+
+            // access a single voice within the arrays below
+            static inline float& lane( SIMD::float4* values, int index ) {
+                return reinterpret_cast<float*>( values )[ index ];
+            }
+
+            // oscillator state per voice (one SIMD::float4 per group)
+
+            SIMD::float4* phase;
+            SIMD::float4* frequency;
+            SIMD::float4* portamentoIncrement;
+            SIMD::float4* portamentoSteps;
+            SIMD::float4* pwm;
+            SIMD::float4* volume;
+
+            // integrator states of the per voice filter (see Filter::processVoices())
+
+            SIMD::float4* filterState1;
+            SIMD::float4* filterState2;
+
+            // per sample envelope gain and pulse width threshold of
+            // the group that is being rendered (one SIMD::float4 per sample)
+
+            SIMD::float4* gain;
+            SIMD::float4* pulseWidth;
+
+            // sum of all groups per lane and the mono sum of all
+            // voices for the segment that is being rendered
+
+            SIMD::float4* output;
+            float* mix;
+
+            // output of the group (or single voice) that is being rendered, when
+            // filtered per voice this is filtered before being added onto the output above
+
+            SIMD::float4* voiceOutput;
+
+            // the Note each lane was gathered from and whether
+            // its envelope completed during the current render iteration
+
+            Note** voices;
+            bool* disposed;
+
+        private:
+            int size;
+            int capacity;
+
+            void dispose();
+    };
+}
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "voicepool.h"
+
+namespace Igorski {
+
+VoicePool::VoicePool()
+{
+    _notes    = nullptr;
+    _free     = nullptr;
+    _capacity = 0;
+    _used     = 0;
+}
+
+VoicePool::~VoicePool()
+{
+    delete[] _notes;
+}
+
+void VoicePool::init( int capacity )
+{
+    delete[] _notes;
+
+    _capacity = capacity;
+    _used     = 0;
+    _notes    = new Note[ capacity ];
+    _free     = nullptr;
+
+    // link all Notes in order of their memory address so subsequently acquired Notes are adjacent
+
+    for ( int i = capacity - 1; i >= 0; --i ) {
+        _notes[ i ].link.next = _free;
+        _free = &_notes[ i ];
+    }
+}
+
+Note* VoicePool::acquire()
+{
+    Note* note = _free;
+
+    if ( note == nullptr ) {
+        return nullptr;
+    }
+    _free = note->link.next;
+    ++_used;
+
+    *note = Note();
+
+    return note;
+}
+
+void VoicePool::release( Note* note )
+{
+    note->link.next = _free;
+    _free           = note;
+    --_used;
+}
+
+}
@@ -0,0 +1,61 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __VOICEPOOL_HEADER__
+#define __VOICEPOOL_HEADER__
+
+#include "note.h"
+
+namespace Igorski {
+
+    /**
+     * Preallocated, contiguous storage for all Notes the Synthesizer can play
+     * simultaneously. Unused Notes are kept in an intrusive free list, so acquiring
+     * and releasing a Note is constant time and never allocates on the audio thread.
+     * Allocation only takes place in init() (e.g. when processing is set up)
+     */
+    class VoicePool {
+
+        public:
+            VoicePool();
+            ~VoicePool();
+
+            // (re)allocates the pool to hold given amount of Notes, all
+            // previously acquired Notes become invalid
+            void init( int capacity );
+
+            // returns a reset Note or nullptr when all Notes are in use
+            Note* acquire();
+            void release( Note* note );
+
+            int getCapacity() { return _capacity; }
+            int getUsed()     { return _used; }
+
+        private:
+            Note* _notes;
+            Note* _free;
+            int _capacity;
+            int _used;
+    };
+}
+
+#endif
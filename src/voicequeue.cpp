@@ -0,0 +1,135 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "voicequeue.h"
+
+namespace Igorski {
+
+VoiceQueue::VoiceQueue()
+{
+    _entries  = nullptr;
+    _capacity = 0;
+    _size     = 0;
+}
+
+VoiceQueue::~VoiceQueue()
+{
+    delete[] _entries;
+}
+
+void VoiceQueue::init( int capacity )
+{
+    delete[] _entries;
+
+    _capacity = capacity;
+    _size     = 0;
+    _entries  = new Entry[ capacity ];
+}
+
+void VoiceQueue::add( Note* note, double priority )
+{
+    if ( _size == _capacity ) {
+        return; // cannot occur as the capacity equals the VoicePool's
+    }
+    place( _size++, { priority, note });
+    moveUp( note->queueIndex );
+}
+
+void VoiceQueue::remove( Note* note )
+{
+    int index = note->queueIndex;
+
+    if ( index < 0 ) {
+        return;
+    }
+    note->queueIndex = -1;
+
+    // move the last entry into the vacated position and restore its order
+
+    if ( index != --_size ) {
+        place( index, _entries[ _size ]);
+        moveDown( moveUp( index ));
+    }
+}
+
+void VoiceQueue::update( Note* note, double priority )
+{
+    int index = note->queueIndex;
+
+    if ( index < 0 ) {
+        return;
+    }
+    _entries[ index ].priority = priority;
+    moveDown( moveUp( index ));
+}
+
+/* private methods */
+
+void VoiceQueue::place( int index, const Entry& entry )
+{
+    _entries[ index ] = entry;
+    entry.note->queueIndex = index;
+}
+
+int VoiceQueue::moveUp( int index )
+{
+    Entry entry = _entries[ index ];
+
+    while ( index > 0 ) {
+        int parent = ( index - 1 ) / 2;
+
+        if ( _entries[ parent ].priority <= entry.priority ) {
+            break;
+        }
+        place( index, _entries[ parent ]);
+        index = parent;
+    }
+    place( index, entry );
+
+    return index;
+}
+
+int VoiceQueue::moveDown( int index )
+{
+    Entry entry = _entries[ index ];
+
+    while ( true ) {
+        int child = index * 2 + 1;
+
+        if ( child >= _size ) {
+            break;
+        }
+        if ( child + 1 < _size && _entries[ child + 1 ].priority < _entries[ child ].priority ) {
+            ++child;
+        }
+        if ( entry.priority <= _entries[ child ].priority ) {
+            break;
+        }
+        place( index, _entries[ child ]);
+        index = child;
+    }
+    place( index, entry );
+
+    return index;
+}
+
+}
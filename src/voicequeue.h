@@ -0,0 +1,73 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __VOICEQUEUE_HEADER__
+#define __VOICEQUEUE_HEADER__
+
+#include "note.h"
+
+namespace Igorski {
+
+    /**
+     * Priority queue of the Notes that can be stolen when the maximum amount of voices is
+     * playing, ordered by their stealing priority (the Note with the lowest priority is
+     * stolen first). The queue is a binary heap whose positions are stored inside the
+     * Notes, so retrieving the first Note is constant time while adding, removing and
+     * reprioritizing a Note is logarithmic. Allocation only takes place in init()
+     */
+    class VoiceQueue {
+
+        public:
+            VoiceQueue();
+            ~VoiceQueue();
+
+            // (re)allocates the queue to hold given amount of Notes
+            void init( int capacity );
+
+            void add( Note* note, double priority );
+            void remove( Note* note );
+            void update( Note* note, double priority );
+
+            // the Note that should be stolen first (nullptr when the queue is empty)
+            Note* first() { return _size > 0 ? _entries[ 0 ].note : nullptr; }
+
+            // access to the queued Notes (in no particular order)
+            Note* get( int index ) { return _entries[ index ].note; }
+
+            int getSize() { return _size; }
+
+        private:
+            struct Entry {
+                double priority;
+                Note* note;
+            };
+            Entry* _entries;
+            int _capacity;
+            int _size;
+
+            void place( int index, const Entry& entry );
+            int moveUp( int index );
+            int moveDown( int index );
+    };
+}
+
+#endif
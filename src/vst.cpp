@@ -23,9 +23,9 @@
 #include "global.h"
 #include "calc.h"
 #include "vst.h"
-#include "synth.h"
-#include "filter.h"
+#include "part.h"
 #include "paramids.h"
+#include "denormals.h"
 
 #include "public.sdk/source/vst/vstaudioprocessoralgo.h"
 
@@ -37,7 +37,9 @@
 
 #include "base/source/fstreamer.h"
 
+#include <algorithm>
 #include <stdio.h>
+#include <string.h>
 
 float Igorski::VST::SAMPLE_RATE = 44100.f; // updated in setupProcessing()
 
@@ -47,17 +49,7 @@ namespace Igorski {
 // VSTSID Implementation
 //------------------------------------------------------------------------
 VSTSID::VSTSID ()
-: fAttack( 0.f )
-, fDecay( 1.f )
-, fSustain( .5f )
-, fRelease( 0.f )
-, fCutoff( .5f )
-, fResonance( 0.f )
-, fLFORate( 0.f )
-, fLFODepth( 1.f )
-, fRingModRate( 0.f )
-, fPitchBendRange( 1.f )
-, fPortamento( 0.f )
+: fMaxVoices( 1.f )
 , currentProcessMode( -1 ) // -1 means not initialized
 {
     // register its editor class (the same as used in entry.cpp)
@@ -69,9 +61,8 @@ VSTSID::VSTSID ()
 
 VSTSID::~VSTSID ()
 {
-    // free all allocated resources
-    delete synth;
-    delete filter;
+    // free all allocated resources (the parts free their own)
+    workerPool.stop();
 }
 
 tresult PLUGIN_API VSTSID::initialize( FUnknown* context )
@@ -103,173 +94,449 @@ tresult PLUGIN_API VSTSID::setActive (TBool state)
     else
         sendTextMessage( "VSTSID::setActive (false)" );
 
+    // the workers rendering the parts of the multi-timbral mode in parallel are started regardless of the
+    // mode (which can be enabled while active), these sleep until the multi-timbral mode submits a job
+
+    if ( state ) {
+        int hardwareThreads = ( int ) std::thread::hardware_concurrency();
+        double blockDuration = processSetup.maxSamplesPerBlock / std::max( 1.0, processSetup.sampleRate );
+        workerPool.start( std::max( 0, std::min( maxWorkers, hardwareThreads - 1 )), blockDuration );
+    } else {
+        workerPool.stop();
+    }
+
     // call our parent setActive
     return AudioEffect::setActive( state );
 }
 
 tresult PLUGIN_API VSTSID::process( ProcessData& data )
 {
-    // read input parameter changes (and update our model accordingly)
+    // flush subnormal values to zero while processing (the hosts floating point mode is restored on return)
 
-    IParameterChanges* paramChanges = data.inputParameterChanges;
-    if ( paramChanges )
-    {
-        int32 numParamsChanged = paramChanges->getParameterCount();
-        // for each parameter which are some changes in this audio block:
-        for ( int32 i = 0; i < numParamsChanged; i++ )
-        {
-            IParamValueQueue* paramQueue = paramChanges->getParameterData( i );
-            if ( paramQueue )
-            {
-                ParamValue value;
-                int32 sampleOffset;
-                int32 numPoints = paramQueue->getPointCount();
-
-                if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value ) != kResultTrue ) {
-                    continue;
-                }
+    DenormalGuard denormalGuard;
 
-                switch ( paramQueue->getParameterId())
-                {
-                    // we use in this example only the last point of the queue.
-                    // in some wanted case for specific kind of parameter it makes sense to retrieve all points
-                    // and process the whole audio block in small blocks.
-
-                    case kAttackId:
-                        fAttack = ( float ) value;
-                        break;
-
-                    case kDecayId:
-                        fDecay = ( float ) value;
-                        break;
-
-                    case kSustainId:
-                        fSustain = ( float ) value;
-                        break;
-
-                    case kReleaseId:
-                        fRelease = ( float ) value;
-                        break;
-
-                    case kCutoffId:
-                        fCutoff = ( float ) value;
-                        break;
-
-                    case kResonanceId:
-                        fResonance = ( float ) value;
-                        break;
-
-                    case kLFORateId:
-                        fLFORate = ( float ) value;
-                        break;
-
-                    case kLFODepthId:
-                        fLFODepth = ( float ) value;
-                        break;
-
-                    case kRingModRateId:
-                        fRingModRate = ( float ) value;
-                        break;
-
-                    case kBypassId:
-                        _bypass = ( value > 0.5f );
-                        break;
-
-                    case kMasterTuningId:
-						fMasterTuning = 2 * ( value - 0.5f ); // -1 to +1 range
-                        scaleTuning();
-						break;
-
-                    case kPitchBendRangeId:
-                        fPitchBendRange = ( float ) value;
-                        scaleTuning();
-                        break;
-
-                    case kPortamentoId:
-                        fPortamento = ( float ) value;
-                        break;
-                }
-                syncModel();
-            }
-        }
-    }
+    loadMeter.startBlock();
 
     // according to docs: processing context (optional, but most welcome)
 
-    if ( data.processContext != nullptr && synth->TEMPO != data.processContext->tempo ) {
-        synth->init(( int ) data.processContext->sampleRate, data.processContext->tempo );
-    }
-
-    //---2) Read input events-------------
-    IEventList* eventList = data.inputEvents;
-    if ( eventList )
-    {
-        int32 numEvent = eventList->getEventCount();
-        for ( int32 i = 0; i < numEvent; i++ )
-        {
-            Event event;
-            if ( eventList->getEvent( i, event ) == kResultOk )
-            {
-                switch ( event.type )
-                {
-                    case Event::kNoteOnEvent:
-                        // event has properties: channel, pitch, velocity, length, tuning, noteId
-                        synth->noteOn( event.noteOn.pitch, event.noteOn.velocity, event.noteOn.tuning );
-                        break;
-
-                    case Event::kNoteOffEvent:
-                        // noteOff reset the reduction
-                        synth->noteOff( event.noteOff.pitch );
-                        break;
-                }
-            }
+    if ( data.processContext != nullptr && parts[ 0 ].getTempo() != data.processContext->tempo ) {
+        for ( Part& part : parts ) {
+            part.setTempo(( int ) data.processContext->sampleRate, data.processContext->tempo );
         }
     }
 
-    // --- synthesize audio
+    IParameterChanges* paramChanges = data.inputParameterChanges;
+    IEventList* eventList           = data.inputEvents;
+
+    // the parameter changes and note events are read in order of their sample offset
+    // (only the cursors of the queues provided by the host are in use, see applyParameterChanges())
+
+    int32 numParamQueues = paramChanges != nullptr ? std::min( paramChanges->getParameterCount(), MAX_PARAMETER_QUEUES ) : 0;
+    std::fill( paramQueueCursors, paramQueueCursors + std::max( 0, numParamQueues ), 0 );
+    eventCursor = 0;
 
     if ( data.numOutputs == 0 ) {
-        // nothing to do
+        // nothing to synthesize, apply all changes at once
+        applyParameterChanges( paramChanges, NO_PENDING_CHANGES );
+        applyEvents( eventList, NO_PENDING_CHANGES );
+
         return kResultOk;
     }
 
     int32 numChannels = data.outputs[ 0 ].numChannels;
+    int32 numSamples  = data.numSamples;
 
     // --- get audio buffers----------------
-    uint32 sampleFramesSize = getSampleFramesSizeInBytes( processSetup, data.numSamples );
+    uint32 sampleFramesSize = getSampleFramesSizeInBytes( processSetup, numSamples );
 //    void** in  = getChannelBuffersPointer( processSetup, data.inputs [ 0 ] );
     void** out = getChannelBuffersPointer( processSetup, data.outputs[ 0 ] );
 
     bool isDoublePrecision = data.symbolicSampleSize == kSample64;
     bool hasContent = false;
 
-    if ( !_bypass )
+    // this is a mono synth: the voices, ring modulator and filter of all parts process
+    // the first channel, which is copied into the remaining channels afterwards
+    // the block is rendered in sub-blocks which are split at the sample offsets of the
+    // parameter changes and note events, applying these sample accurately at any block size
+
+    for ( int32 offset = 0, length = 0; offset < numSamples; offset += length )
     {
+        // parameters are applied before the note events at the same offset
+
+        int32 nextParameterOffset = applyParameterChanges( paramChanges, offset );
+        int32 nextEventOffset     = applyEvents( eventList, offset );
+
+        length = std::min( std::min( nextParameterOffset, nextEventOffset ), numSamples ) - offset;
+
+        if ( _bypass || numChannels == 0 ) {
+            continue;
+        }
+
+        // automated cutoff, resonance and ring modulator rate are ramped towards their next point
+        // (their remaining parameter changes are applied as steps)
+
+        rampParameterChanges( paramChanges, offset, length );
+
         // synthesize !
 
-        if ( isDoublePrecision ) {
-            hasContent = synth->synthesize<double>(
-                ( double** ) out, numChannels, data.numSamples, sampleFramesSize
-            );
+        bool rendered = isDoublePrecision ? renderSubBlock<double>(( double* ) out[ 0 ], offset, length )
+                                          : renderSubBlock<float> (( float* )  out[ 0 ], offset, length );
+
+        completeRamps();
+
+        // silent sub-blocks are left untouched, these only need clearing once
+        // the block has content (otherwise all channels are cleared below)
+
+        if ( rendered && !hasContent ) {
+            memset( out[ 0 ], 0, getSampleFramesSizeInBytes( processSetup, offset ));
+        } else if ( !rendered && hasContent ) {
+            memset(( char* ) out[ 0 ] + getSampleFramesSizeInBytes( processSetup, offset ), 0,
+                   getSampleFramesSizeInBytes( processSetup, length ));
+        }
+        hasContent = rendered || hasContent;
+    }
+
+    // changes positioned beyond the end of the block (should not occur) are applied last,
+    // this also applies all changes for blocks without samples (e.g. parameter flushes)
+
+    applyParameterChanges( paramChanges, NO_PENDING_CHANGES );
+    applyEvents( eventList, NO_PENDING_CHANGES );
+
+    // fan out the mono output into all channels (or clear them when nothing was synthesized)
+
+    for ( int32 c = 0; c < numChannels; ++c ) {
+        if ( !hasContent ) {
+            memset( out[ c ], 0, sampleFramesSize );
+        } else if ( c > 0 ) {
+            memcpy( out[ c ], out[ 0 ], sampleFramesSize );
+        }
+    }
 
-            if ( hasContent ) {
-                filter->process<double>(( double** ) out, numChannels, data.numSamples );
+    // flag all channels as silent when no content had been synthesized (allowing
+    // the host and the plugins further down the chain to skip processing them)
+
+    data.outputs[ 0 ].silenceFlags = hasContent ? 0 : ( numChannels >= 64 ) ? ~( uint64 ) 0 : (( uint64 ) 1 << numChannels ) - 1;
+
+    // the recursive state of the parts is flushed to zero as it decays, the flushes are counted where these occur
+
+    int voiceAmount   = 0;
+    int flushedValues = 0;
+    for ( Part& part : parts ) {
+        voiceAmount   += part.getVoiceAmount();
+        flushedValues += part.collectFlushedValues();
+    }
+
+    if ( loadMeter.endBlock( numSamples, voiceAmount, flushedValues )) {
+        publishLoad( data.outputParameterChanges );
+    }
+    return kResultOk;
+}
+
+template <typename SampleType>
+bool VSTSID::renderSubBlock( SampleType* buffer, int32 offset, int32 length )
+{
+    // in single-timbral mode only the first part receives notes, though the other parts can
+    // still be sounding the notes they received before multi-timbral mode was disabled
+
+    soundingPartAmount = 0;
+    for ( int i = 1; i < VST::MAX_PARTS; ++i ) {
+        if ( !parts[ i ].isIdle()) {
+            soundingParts[ soundingPartAmount++ ] = &parts[ i ];
+        }
+    }
+
+    // a single sounding part is rendered directly into the output buffer
+
+    if ( soundingPartAmount == 0 ) {
+        return parts[ 0 ].render<SampleType>( buffer + offset, offset, length, &loadMeter );
+    }
+    if ( parts[ 0 ].isIdle() && soundingPartAmount == 1 ) {
+        return soundingParts[ 0 ]->render<SampleType>( buffer + offset, offset, length, &loadMeter );
+    }
+    soundingParts[ soundingPartAmount++ ] = &parts[ 0 ];
+
+    // multiple parts are rendered in parallel into their own buffers (in ranges that fit these),
+    // after which they are mixed into the output buffer. The stages of the individual parts
+    // are not metered, their combined duration is measured as the synthesis load
+
+    bool hasContent = false;
+
+    for ( int32 position = 0; position < length; position += renderLength )
+    {
+        renderOffset = offset + position;
+        renderLength = std::min( length - position, Part::BUFFER_SIZE );
+
+        loadMeter.startStage();
+        workerPool.run( soundingPartAmount, &VSTSID::renderPart<SampleType>, this );
+        loadMeter.endStage( DSPLoadMeter::SYNTHESIS );
+
+        SampleType* output = buffer + renderOffset;
+        bool mixed = false;
+
+        for ( int i = 0; i < soundingPartAmount; ++i )
+        {
+            if ( !soundingParts[ i ]->rendered ) {
+                continue;
             }
-        } else {
-            hasContent = synth->synthesize<float>(
-                ( float** ) out, numChannels, data.numSamples, sampleFramesSize
-            );
+            SampleType* partBuffer = reinterpret_cast<SampleType*>( soundingParts[ i ]->buffer );
 
-            if ( hasContent ) {
-                filter->process<float>(( float** ) out, numChannels, data.numSamples );
+            if ( mixed ) {
+                for ( int32 j = 0; j < renderLength; ++j ) {
+                    output[ j ] += partBuffer[ j ];
+                }
+            } else {
+                memcpy( output, partBuffer, renderLength * sizeof( SampleType ));
+                mixed = true;
             }
         }
+
+        // ranges that follow a silent range need it cleared (a block without content is cleared by process())
+
+        if ( mixed && !hasContent && position > 0 ) {
+            memset( buffer + offset, 0, position * sizeof( SampleType ));
+        } else if ( !mixed && hasContent ) {
+            memset( output, 0, renderLength * sizeof( SampleType ));
+        }
+        hasContent = mixed || hasContent;
     }
+    return hasContent;
+}
 
-    // mark our outputs as not silent if content had been synthesized
-    data.outputs[ 0 ].silenceFlags = !hasContent;
+template <typename SampleType>
+void VSTSID::renderPart( void* plugin, int index )
+{
+    VSTSID* instance = static_cast<VSTSID*>( plugin );
+    Part* part       = instance->soundingParts[ index ];
 
-    return kResultOk;
+    part->rendered = part->render<SampleType>(
+        reinterpret_cast<SampleType*>( part->buffer ), instance->renderOffset, instance->renderLength, nullptr
+    );
+}
+
+int32 VSTSID::applyParameterChanges( IParameterChanges* paramChanges, int32 sampleOffset )
+{
+    int32 nextOffset = NO_PENDING_CHANGES;
+
+    if ( paramChanges == nullptr ) {
+        return nextOffset;
+    }
+
+    // the host provides a single queue per changed parameter, as such there are no more queues
+    // than there are parameter ids (including those of all parts, see MAX_PARAMETER_QUEUES)
+    // the excess of a host that provides more is ignored
+
+    int32 numParamsChanged = std::min( paramChanges->getParameterCount(), MAX_PARAMETER_QUEUES );
+    bool changed = false;
+
+    for ( int32 i = 0; i < numParamsChanged; ++i )
+    {
+        IParamValueQueue* paramQueue = paramChanges->getParameterData( i );
+        if ( !paramQueue ) {
+            continue;
+        }
+        int32 numPoints = paramQueue->getPointCount();
+        int32& cursor   = paramQueueCursors[ i ];
+
+        ParamValue value;
+        int32 pointOffset;
+
+        for ( ; cursor < numPoints; ++cursor )
+        {
+            if ( paramQueue->getPoint( cursor, pointOffset, value ) != kResultTrue ) {
+                continue;
+            }
+            if ( pointOffset > sampleOffset ) {
+                nextOffset = std::min( nextOffset, pointOffset );
+                break;
+            }
+            applyParameter( paramQueue->getParameterId(), value );
+            changed = true;
+        }
+    }
+
+    if ( changed ) {
+        syncModel();
+    }
+    return nextOffset;
+}
+
+void VSTSID::rampParameterChanges( IParameterChanges* paramChanges, int32 sampleOffset, int32 length )
+{
+    if ( paramChanges == nullptr || length <= 0 ) {
+        return;
+    }
+
+    // (read in the same range as applyParameterChanges())
+
+    int32 numParamsChanged = std::min( paramChanges->getParameterCount(), MAX_PARAMETER_QUEUES );
+
+    for ( int32 i = 0; i < numParamsChanged; ++i )
+    {
+        IParamValueQueue* paramQueue = paramChanges->getParameterData( i );
+        if ( !paramQueue ) {
+            continue;
+        }
+        ParamID id = paramQueue->getParameterId();
+        int part   = VST::getPart( id );
+        int baseId = VST::getBaseParameterId( id );
+
+        if ( part >= VST::MAX_PARTS || std::find( SMOOTHED_PARAMETERS, SMOOTHED_PARAMETERS + SMOOTHED_PARAMETER_AMOUNT, baseId ) ==
+                                       SMOOTHED_PARAMETERS + SMOOTHED_PARAMETER_AMOUNT ) {
+            continue;
+        }
+
+        // the cursor points at the next pending point (all points up to the offset have been applied)
+
+        ParamValue value;
+        int32 pointOffset;
+        int32 cursor = paramQueueCursors[ i ];
+
+        if ( cursor >= paramQueue->getPointCount() || paramQueue->getPoint( cursor, pointOffset, value ) != kResultTrue ||
+             pointOffset <= sampleOffset ) {
+            continue;
+        }
+
+        // the value at the end of the sub-block on the line towards the next point (as the sub-blocks
+        // are split at each point, the sub-block ends at or before the point)
+
+        int32 distance = pointOffset - sampleOffset;
+        double current = parts[ part ].getParameter( baseId );
+
+        // at a rate of 0 the ring modulator is off (and the synthesizer switches waveforms),
+        // switching it on or off is applied at the offset of the point instead
+
+        if ( baseId == kRingModRateId && ( current == 0.0 || value == 0.0 )) {
+            continue;
+        }
+        if ( length < distance ) {
+            value = current + ( value - current ) * ( length / ( double ) distance );
+        }
+        parts[ part ].setParameter( baseId, value );
+        rampedParts[ part ] = true;
+    }
+
+    for ( int i = 0; i < VST::MAX_PARTS; ++i ) {
+        if ( rampedParts[ i ]) {
+            parts[ i ].rampModel( length );
+        }
+    }
+}
+
+void VSTSID::completeRamps()
+{
+    for ( int i = 0; i < VST::MAX_PARTS; ++i ) {
+        if ( rampedParts[ i ]) {
+            parts[ i ].completeRamps();
+            rampedParts[ i ] = false;
+        }
+    }
+}
+
+int32 VSTSID::applyEvents( IEventList* eventList, int32 sampleOffset )
+{
+    if ( !eventList ) {
+        return NO_PENDING_CHANGES;
+    }
+    int32 numEvent = eventList->getEventCount();
+
+    for ( ; eventCursor < numEvent; ++eventCursor )
+    {
+        Event event;
+        if ( eventList->getEvent( eventCursor, event ) != kResultOk ) {
+            continue;
+        }
+        if ( event.sampleOffset > sampleOffset ) {
+            return event.sampleOffset;
+        }
+
+        // in multi-timbral mode, each MIDI channel plays its own part
+
+        switch ( event.type )
+        {
+            case Event::kNoteOnEvent:
+                // event has properties: channel, pitch, velocity, length, tuning, noteId
+                getPart( event.noteOn.channel ).noteOn( event.noteOn.pitch, event.noteOn.velocity, event.noteOn.tuning );
+                break;
+
+            case Event::kNoteOffEvent:
+                // noteOff reset the reduction
+                getPart( event.noteOff.channel ).noteOff( event.noteOff.pitch );
+                break;
+        }
+    }
+    return NO_PENDING_CHANGES;
+}
+
+void VSTSID::applyParameter( ParamID id, ParamValue value )
+{
+    // the sound parameters apply to a single part
+
+    int part = VST::getPart( id );
+
+    if ( part < VST::MAX_PARTS && parts[ part ].setParameter( VST::getBaseParameterId( id ), value )) {
+        changedParts[ part ] = true;
+        return;
+    }
+
+    switch ( id )
+    {
+        case kBypassId:
+            _bypass = ( value > 0.5f );
+            break;
+
+        case kBandLimitedId:
+            _bandLimited = ( value > 0.5f );
+            break;
+
+        case kMaxVoicesId:
+            fMaxVoices = ( float ) value;
+            break;
+
+        case kVoiceStealingId:
+            _voiceStealing = std::min(( int32 ) round( value * ( VST::VOICE_STEALING_POLICIES - 1 )), VST::VOICE_STEALING_POLICIES - 1 );
+            break;
+
+        case kMultiTimbralId:
+            setMultiTimbral( value > 0.5f );
+            return;
+
+        case kFilterModeId:
+            _filterMode = std::min(( int32 ) round( value * ( VST::FILTER_MODES - 1 )), VST::FILTER_MODES - 1 );
+            break;
+
+        case kVoiceFilterId:
+            _voiceFilter = ( value > 0.5f );
+            break;
+
+        case kFilterEnvelopeId:
+            fFilterEnvelope = ( float ) value;
+            break;
+
+        default:
+            return;
+    }
+    flagChanged();
+}
+
+Part& VSTSID::getPart( int16 channel )
+{
+    return _multiTimbral ? parts[ std::max( 0, std::min(( int ) channel, VST::MAX_PARTS - 1 )) ] : parts[ 0 ];
+}
+
+void VSTSID::setMultiTimbral( bool value )
+{
+    if ( value == _multiTimbral ) {
+        return;
+    }
+    _multiTimbral = value;
+
+    // the other parts no longer receive note events in single-timbral mode, release their notes
+
+    if ( !_multiTimbral ) {
+        for ( int i = 1; i < VST::MAX_PARTS; ++i ) {
+            parts[ i ].releaseAll();
+        }
+    }
 }
 
 tresult VSTSID::receiveText( const char* text )
@@ -330,10 +597,14 @@ tresult PLUGIN_API VSTSID::setState( IBStream* state )
         _bypass = savedBypass > 0;
     }
 
+    // the first part holds the sound parameters of the single-timbral mode
+
+    Part& part = parts[ 0 ];
+
     // may fail as these were only added in version 1.1.0
     float savedTuning = 0.f;
     if ( streamer.readFloat( savedTuning ) != false ) {
-        fMasterTuning = savedTuning;
+        part.fMasterTuning = savedTuning;
     } else {
         // in v1.1.0 we fixed a bug with the way resonance was saved
         // correct value to ensure saved presets in older plugin versions sound the same
@@ -342,25 +613,73 @@ tresult PLUGIN_API VSTSID::setState( IBStream* state )
 
     float savedPBrange = 0.f;
     if ( streamer.readFloat( savedPBrange ) != false ) {
-        fPitchBendRange = savedPBrange;
+        part.fPitchBendRange = savedPBrange;
     }
 
     float savedPortamento = 0;
     if ( streamer.readFloat( savedPortamento ) != false ) {
-        fPortamento = savedPortamento;
+        part.fPortamento = savedPortamento;
     }
 
-    fAttack      = savedAttack;
-    fDecay       = savedDecay;
-    fSustain     = savedSustain;
-    fRelease     = savedRelease;
-    fCutoff      = savedCutoff;
-    fResonance   = savedResonance;
-    fLFORate     = savedLFORate;
-    fLFODepth    = savedLFODepth;
-    fRingModRate = savedRingModRate;
+    // may fail as this was only added after version 1.1.2
+    int32 savedBandLimited = 0;
+    if ( streamer.readInt32( savedBandLimited ) != false ) {
+        _bandLimited = savedBandLimited > 0;
+    }
+
+    float savedMaxVoices = 1.f;
+    if ( streamer.readFloat( savedMaxVoices ) != false ) {
+        fMaxVoices = savedMaxVoices;
+    }
 
-    scaleTuning();
+    int32 savedVoiceStealing = 0;
+    if ( streamer.readInt32( savedVoiceStealing ) != false ) {
+        _voiceStealing = std::max( 0, std::min( savedVoiceStealing, VST::VOICE_STEALING_POLICIES - 1 ));
+    }
+
+    // followed by the sound parameters of the other parts (as normalized values in order of PART_PARAMETERS)
+
+    int32 savedMultiTimbral = 0;
+    if ( streamer.readInt32( savedMultiTimbral ) != false ) {
+        setMultiTimbral( savedMultiTimbral > 0 );
+
+        for ( int i = 1; i < VST::MAX_PARTS; ++i ) {
+            for ( int p = 0; p < PART_PARAMETER_AMOUNT; ++p ) {
+                float savedValue = 0.f;
+                if ( streamer.readFloat( savedValue ) != false ) {
+                    parts[ i ].setParameter( PART_PARAMETERS[ p ], savedValue );
+                }
+            }
+        }
+    }
+
+    int32 savedFilterMode = 0;
+    if ( streamer.readInt32( savedFilterMode ) != false ) {
+        _filterMode = std::max( 0, std::min( savedFilterMode, VST::FILTER_MODES - 1 ));
+    }
+
+    int32 savedVoiceFilter = 0;
+    if ( streamer.readInt32( savedVoiceFilter ) != false ) {
+        _voiceFilter = savedVoiceFilter > 0;
+    }
+
+    float savedFilterEnvelope = 0.f;
+    if ( streamer.readFloat( savedFilterEnvelope ) != false ) {
+        fFilterEnvelope = savedFilterEnvelope;
+    }
+
+    part.fAttack      = savedAttack;
+    part.fDecay       = savedDecay;
+    part.fSustain     = savedSustain;
+    part.fRelease     = savedRelease;
+    part.fCutoff      = savedCutoff;
+    part.fResonance   = savedResonance;
+    part.fLFORate     = savedLFORate;
+    part.fLFODepth    = savedLFODepth;
+    part.fRingModRate = savedRingModRate;
+
+    part.scaleTuning();
+    flagChanged();
     syncModel();
 
     // Example of using the IStreamAttributes interface
@@ -404,23 +723,49 @@ tresult PLUGIN_API VSTSID::getState( IBStream* state )
 
     IBStreamer streamer( state, kLittleEndian );
 
-    streamer.writeFloat( fAttack );
-    streamer.writeFloat( fDecay );
-    streamer.writeFloat( fSustain );
-    streamer.writeFloat( fRelease );
-    streamer.writeFloat( fCutoff );
-    streamer.writeFloat( fResonance );
-    streamer.writeFloat( fLFORate );
-    streamer.writeFloat( fLFODepth );
-    streamer.writeFloat( fRingModRate );
+    Part& part = parts[ 0 ];
+
+    streamer.writeFloat( part.fAttack );
+    streamer.writeFloat( part.fDecay );
+    streamer.writeFloat( part.fSustain );
+    streamer.writeFloat( part.fRelease );
+    streamer.writeFloat( part.fCutoff );
+    streamer.writeFloat( part.fResonance );
+    streamer.writeFloat( part.fLFORate );
+    streamer.writeFloat( part.fLFODepth );
+    streamer.writeFloat( part.fRingModRate );
     streamer.writeInt32( _bypass ? 1 : 0 );
-    streamer.writeFloat( fMasterTuning );
-    streamer.writeFloat( fPitchBendRange );
-    streamer.writeFloat( fPortamento );
+    streamer.writeFloat( part.fMasterTuning );
+    streamer.writeFloat( part.fPitchBendRange );
+    streamer.writeFloat( part.fPortamento );
+    streamer.writeInt32( _bandLimited ? 1 : 0 );
+    streamer.writeFloat( fMaxVoices );
+    streamer.writeInt32( _voiceStealing );
+    streamer.writeInt32( _multiTimbral ? 1 : 0 );
+
+    for ( int i = 1; i < VST::MAX_PARTS; ++i ) {
+        for ( int p = 0; p < PART_PARAMETER_AMOUNT; ++p ) {
+            streamer.writeFloat( parts[ i ].getParameter( PART_PARAMETERS[ p ]));
+        }
+    }
+    streamer.writeInt32( _filterMode );
+    streamer.writeInt32( _voiceFilter ? 1 : 0 );
+    streamer.writeFloat( fFilterEnvelope );
 
     return kResultOk;
 }
 
+uint32 PLUGIN_API VSTSID::getTailSamples()
+{
+    // the longest tail of all parts
+
+    int tailSamples = 0;
+    for ( Part& part : parts ) {
+        tailSamples = std::max( tailSamples, part.getTailSamples());
+    }
+    return ( uint32 ) tailSamples;
+}
+
 tresult PLUGIN_API VSTSID::setupProcessing( ProcessSetup& newSetup )
 {
     // called before the process call, always in a disabled state (not active)
@@ -431,6 +776,7 @@ tresult PLUGIN_API VSTSID::setupProcessing( ProcessSetup& newSetup )
     Igorski::VST::SAMPLE_RATE = newSetup.sampleRate;
 
     initPlugin( newSetup.sampleRate );
+    loadMeter.init( newSetup.sampleRate, newSetup.maxSamplesPerBlock );
 
     return AudioEffect::setupProcessing( newSetup );
 }
@@ -481,28 +827,66 @@ tresult PLUGIN_API VSTSID::notify( IMessage* message )
 
 void VSTSID::initPlugin( float sampleRate )
 {
-    if ( synth != nullptr ) {
-        delete synth;
-        delete filter;
+    for ( Part& part : parts ) {
+        part.init( sampleRate );
     }
+    flagChanged();
+    syncModel();
+}
 
-    synth = new Igorski::Synthesizer();
-    synth->init( sampleRate, 120.f );
+void VSTSID::publishLoad( IParameterChanges* outputParameterChanges )
+{
+    if ( outputParameterChanges == nullptr ) {
+        return;
+    }
 
-    filter = new Igorski::Filter( sampleRate );
+    // the output parameter changes are delivered to the controller by the host, which
+    // makes these a lock-free channel between the audio thread and the editor
 
-    syncModel();
+    auto publish = [ outputParameterChanges ]( ParamID id, float value, float maxValue ) {
+        int32 index = 0;
+        IParamValueQueue* queue = outputParameterChanges->addParameterData( id, index );
+        if ( queue != nullptr ) {
+            queue->addPoint( 0, std::min( 1.f, value / maxValue ), index );
+        }
+    };
+
+    const DSPLoadMeter::StageLoad& synthesis = loadMeter.getLoad( DSPLoadMeter::SYNTHESIS );
+    const DSPLoadMeter::StageLoad& filtering = loadMeter.getLoad( DSPLoadMeter::FILTER );
+    const DSPLoadMeter::StageLoad& ringMod   = loadMeter.getLoad( DSPLoadMeter::RING_MODULATOR );
+    const DSPLoadMeter::StageLoad& total     = loadMeter.getLoad( DSPLoadMeter::TOTAL );
+
+    publish( kSynthesisLoadId, synthesis.average, VST::MAX_METERED_LOAD );
+    publish( kSynthesisPeakId, synthesis.max,     VST::MAX_METERED_LOAD );
+    publish( kFilterLoadId,    filtering.average, VST::MAX_METERED_LOAD );
+    publish( kFilterPeakId,    filtering.max,     VST::MAX_METERED_LOAD );
+    publish( kRingModLoadId,   ringMod.average,   VST::MAX_METERED_LOAD );
+    publish( kRingModPeakId,   ringMod.max,       VST::MAX_METERED_LOAD );
+    publish( kTotalLoadId,     total.average,     VST::MAX_METERED_LOAD );
+    publish( kTotalPeakId,     total.max,         VST::MAX_METERED_LOAD );
+    publish( kSynthesisMinId,  synthesis.min,     VST::MAX_METERED_LOAD );
+    publish( kFilterMinId,     filtering.min,     VST::MAX_METERED_LOAD );
+    publish( kRingModMinId,    ringMod.min,       VST::MAX_METERED_LOAD );
+    publish( kTotalMinId,      total.min,         VST::MAX_METERED_LOAD );
+    publish( kActiveVoicesId,  ( float ) loadMeter.getActiveVoices(), ( float ) VST::MAX_METERED_VOICES );
+    publish( kFlushedValuesId, ( float ) loadMeter.getFlushedValues(), ( float ) VST::MAX_METERED_FLUSHES );
 }
 
-void VSTSID::scaleTuning()
+void VSTSID::flagChanged()
 {
-    _scaledTuning = Calc::pitchShiftFactor( fMasterTuning * round( fPitchBendRange * VST::MAX_PITCH_BEND ));
+    std::fill( changedParts, changedParts + VST::MAX_PARTS, true );
 }
 
 void VSTSID::syncModel()
 {
-    synth->updateProperties( fAttack, fDecay, fSustain, fRelease, fRingModRate, _scaledTuning, fPortamento );
-    filter->updateProperties( fCutoff, Calc::inverseNormalize( fResonance ), fLFORate, fLFODepth );
+    int maxVoices = 1 + ( int ) round( fMaxVoices * ( VST::MAX_POLYPHONY - 1 ));
+
+    for ( int i = 0; i < VST::MAX_PARTS; ++i ) {
+        if ( changedParts[ i ]) {
+            parts[ i ].syncModel( _bandLimited, maxVoices, _voiceStealing, _filterMode, _voiceFilter, fFilterEnvelope );
+            changedParts[ i ] = false;
+        }
+    }
 }
 
 } // E.O. namespace Igorski
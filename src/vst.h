@@ -25,8 +25,10 @@
 
 #include "public.sdk/source/vst/vstaudioeffect.h"
 #include "global.h"
-#include "synth.h"
-#include "filter.h"
+#include "paramids.h"
+#include "part.h"
+#include "dspmeter.h"
+#include "workerpool.h"
 
 using namespace Steinberg::Vst;
 
@@ -69,6 +71,9 @@ class VSTSID : public AudioEffect
         tresult PLUGIN_API setState( IBStream* state ) SMTG_OVERRIDE;
         tresult PLUGIN_API getState( IBStream* state ) SMTG_OVERRIDE;
 
+        /** The amount of samples the output continues to sound after the last noteOff */
+        uint32 PLUGIN_API getTailSamples() SMTG_OVERRIDE;
+
         /** Will be called before any process call */
         tresult PLUGIN_API setupProcessing( ProcessSetup& newSetup ) SMTG_OVERRIDE;
 
@@ -83,37 +88,89 @@ class VSTSID : public AudioEffect
         /** We want to receive message. */
         tresult PLUGIN_API notify( IMessage* message ) SMTG_OVERRIDE;
 
-    protected:
-
-        // our model values, these are all 0 - 1 range
-        // (normalized) RangeParameter values
+        // limits the amount of worker threads started upon the next activation (e.g. for
+        // offline tools comparing against rendering all parts on the calling thread with 0)
+        void setMaxWorkers( int amount ) { maxWorkers = amount; }
 
-        float fAttack;
-        float fDecay;
-        float fSustain;
-        float fRelease;
+    protected:
 
-        float fCutoff;
-        float fResonance;
-        float fLFORate;
-        float fLFODepth;
+        // our model values, the sound parameters are owned by each part (see Part)
+        // the remaining values are shared by all parts
 
-        float fRingModRate;
-        float fMasterTuning;
-        float fPitchBendRange;
-        float fPortamento;
+        float fMaxVoices;
 
-        float _scaledTuning = 1.f;
         bool _bypass = false;
+        bool _bandLimited = false;
+        int32 _voiceStealing = 0;
+        int32 _filterMode = 0;
+        bool _voiceFilter = false;
+        float fFilterEnvelope = 0.f;
+        bool _multiTimbral = false;
 
         int32 currentProcessMode;
 
-        Igorski::Synthesizer* synth  = nullptr;
-        Igorski::Filter*      filter = nullptr;
+        // the first part plays all notes, unless in multi-timbral mode where each
+        // MIDI channel plays its own part. Sounding parts are rendered in parallel
+
+        Igorski::Part parts[ VST::MAX_PARTS ];
+        Igorski::WorkerPool workerPool;
+        int maxWorkers = VST::MAX_WORKERS;
+
+        Igorski::Part* soundingParts[ VST::MAX_PARTS ];
+        int soundingPartAmount = 0;
+        int32 renderOffset = 0;
+        int32 renderLength = 0;
+
+        // renders the sounding part at given index into its own buffer (executed by the worker pool)
+        template <typename SampleType>
+        static void renderPart( void* plugin, int index );
+
+        Igorski::DSPLoadMeter loadMeter;
+
+        // parameter changes and note events are applied at their sample offset within the block,
+        // these are the read positions within the hosts parameter queues (by queue index) and event list
+        // (the host provides a single queue per changed parameter, of which there is one per parameter id)
+
+        static_assert( kTotalMinId < VST::PART_PARAMETER_OFFSET, "the shared parameter ids must precede those of the second part" );
+
+        // the amount of parameter ids, the highest of which is the last sound parameter of the last part
+
+        static constexpr int32 MAX_PARAMETER_QUEUES = ( VST::MAX_PARTS - 1 ) * VST::PART_PARAMETER_OFFSET + getHighestPartParameter() + 1;
+        static constexpr int32 NO_PENDING_CHANGES   = 0x7FFFFFFF;
+
+        int32 paramQueueCursors[ MAX_PARAMETER_QUEUES ];
+        int32 eventCursor = 0;
+
+        // apply all parameter changes / note events positioned up to (and including) given sample
+        // offset, returning the sample offset of the next pending change (or NO_PENDING_CHANGES)
+
+        int32 applyParameterChanges( IParameterChanges* paramChanges, int32 sampleOffset );
+        int32 applyEvents( IEventList* eventList, int32 sampleOffset );
+        void applyParameter( ParamID id, ParamValue value );
+
+        // the smoothed sound parameters (see SMOOTHED_PARAMETERS) ramp linearly towards their next pending point
+        // over the sub-block of given range (after the changes up to its offset have been applied), the parts
+        // flagged as ramping have their ramps completed once the sub-block has been rendered
+
+        bool rampedParts[ VST::MAX_PARTS ] = {};
+        void rampParameterChanges( IParameterChanges* paramChanges, int32 sampleOffset, int32 length );
+        void completeRamps();
+
+        // the part playing the notes of given MIDI channel
+        Igorski::Part& getPart( int16 channel );
+        void setMultiTimbral( bool value );
+
+        // render given range of the (mono) output buffer, returns false (leaving the range untouched) when silent
+        template <typename SampleType>
+        bool renderSubBlock( SampleType* buffer, int32 offset, int32 length );
+
+        // publishes the DSP load meter readings to the controller as read-only parameters
+        void publishLoad( IParameterChanges* outputParameterChanges );
 
-        // synchronize the processors model after UI led changes
+        // synchronize the processors model after UI led changes (of the parts flagged as changed)
 
-        void scaleTuning();
+        bool changedParts[ VST::MAX_PARTS ];
+        void flagChanged();
         void syncModel();
         void initPlugin( float sampleRate );
 };
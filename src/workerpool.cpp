@@ -0,0 +1,297 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "workerpool.h"
+#include "denormals.h"
+#include <algorithm>
+#include <chrono>
+
+#if defined( _WIN32 )
+#include <windows.h>
+#elif defined( __APPLE__ )
+#include <dispatch/dispatch.h>
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <mach/thread_policy.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#endif
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#endif
+
+namespace Igorski {
+
+namespace {
+
+    // hints the processor that the calling thread is busy waiting
+
+    inline void pause()
+    {
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+        _mm_pause();
+#elif defined( __aarch64__ ) || defined( __arm__ )
+        __asm__ __volatile__( "yield" );
+#endif
+    }
+}
+
+WorkerPool::WorkerPool()
+: work( 0 )
+, pending( 0 )
+, sleeping( 0 )
+, running( false )
+, period( 0.0 )
+, task( nullptr )
+, context( nullptr )
+, taskAmount( 0 )
+{
+
+}
+
+WorkerPool::~WorkerPool()
+{
+    stop();
+}
+
+void WorkerPool::start( int workerAmount, double aPeriod )
+{
+    stop();
+
+    period = aPeriod;
+    running.store( true );
+
+    for ( int i = 0; i < workerAmount; ++i ) {
+        workers.emplace_back( &WorkerPool::workerLoop, this );
+    }
+}
+
+void WorkerPool::stop()
+{
+    if ( workers.empty()) {
+        return;
+    }
+    running.store( false );
+
+    for ( size_t i = 0; i < workers.size(); ++i ) {
+        semaphore.post();
+    }
+    for ( std::thread& worker : workers ) {
+        worker.join();
+    }
+    workers.clear();
+    sleeping.store( 0 );
+}
+
+void WorkerPool::run( int aTaskAmount, Task aTask, void* aContext )
+{
+    if ( workers.empty()) {
+        for ( int i = 0; i < aTaskAmount; ++i ) {
+            aTask( aContext, i );
+        }
+        return;
+    }
+
+    // no tasks can be claimed at this point (the previous job has completed), publish the new job
+
+    task       = aTask;
+    context    = aContext;
+    taskAmount = aTaskAmount;
+
+    pending.store( aTaskAmount, std::memory_order_relaxed );
+
+    uint64_t generation = ( work.load( std::memory_order_relaxed ) >> 32 ) + 1;
+    work.store(( generation << 32 ) | ( uint32_t ) aTaskAmount );
+
+    // wake the sleeping workers (the calling thread executes one of the tasks), this is
+    // the only system call made while submitting and is skipped when none are sleeping
+
+    for ( int i = std::min( sleeping.load(), aTaskAmount - 1 ); i > 0; --i ) {
+        semaphore.post();
+    }
+
+    while ( claim()) {}
+
+    // await the tasks claimed by the workers, should these take longer than expected (e.g. a worker
+    // has been preempted) the processor is yielded instead, so a preempted worker can resume
+
+    using clock = std::chrono::steady_clock;
+    clock::time_point deadline = clock::now() + std::chrono::microseconds( SPIN_MICROSECONDS );
+
+    for ( int spins = 1; pending.load( std::memory_order_acquire ) > 0; ++spins ) {
+        if ( spins % 64 != 0 || clock::now() < deadline ) {
+            pause();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool WorkerPool::claim()
+{
+    uint64_t current = work.load( std::memory_order_acquire );
+
+    while (( uint32_t ) current > 0 )
+    {
+        if ( work.compare_exchange_weak( current, current - 1, std::memory_order_acq_rel, std::memory_order_acquire ))
+        {
+            // the job cannot complete (nor can a new job be submitted) before this
+            // task has completed, as such the properties of the job are stable
+
+            task( context, taskAmount - ( int ) ( uint32_t ) current );
+            pending.fetch_sub( 1, std::memory_order_release );
+
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkerPool::workerLoop()
+{
+    using clock = std::chrono::steady_clock;
+
+    // the floating point mode is per thread, the workers render with subnormal values flushed to zero
+
+    DenormalGuard denormalGuard;
+
+    // when denied, the worker runs at normal priority (see class description)
+
+    promoteToRealTime();
+
+    uint32_t generation = ( uint32_t ) ( work.load() >> 32 );
+
+    while ( running.load( std::memory_order_acquire ))
+    {
+        // await the next job, spinning for a short while before going to sleep
+
+        clock::time_point deadline = clock::now() + std::chrono::microseconds( SPIN_MICROSECONDS );
+
+        for ( int spins = 1; running.load( std::memory_order_relaxed ); ++spins )
+        {
+            if (( uint32_t ) ( work.load( std::memory_order_acquire ) >> 32 ) != generation ) {
+                break;
+            }
+            if ( spins % 64 != 0 || clock::now() < deadline ) {
+                pause();
+                continue;
+            }
+            // the submitting thread reads the amount of sleeping workers after publishing
+            // a job, as such the job is either seen here or this worker is woken
+
+            sleeping.fetch_add( 1 );
+
+            if (( uint32_t ) ( work.load() >> 32 ) == generation && running.load()) {
+                semaphore.wait();
+            }
+            sleeping.fetch_sub( 1 );
+
+            deadline = clock::now() + std::chrono::microseconds( SPIN_MICROSECONDS );
+        }
+        generation = ( uint32_t ) ( work.load( std::memory_order_acquire ) >> 32 );
+
+        while ( claim()) {}
+    }
+}
+
+/* real-time priority */
+
+#if defined( _WIN32 )
+
+bool WorkerPool::promoteToRealTime()
+{
+    return SetThreadPriority( GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL ) != 0;
+}
+
+#elif defined( __APPLE__ )
+
+bool WorkerPool::promoteToRealTime()
+{
+    // the worker computes for at most the duration of a block, within each period of a block
+
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info( &timebase );
+
+    double blockDuration = ( period > 0.0 ? period : 0.01 ) * 1e9 * timebase.denom / timebase.numer; // in absolute time units
+
+    thread_time_constraint_policy_data_t policy;
+    policy.period      = ( uint32_t ) blockDuration;
+    policy.computation = ( uint32_t ) ( blockDuration / 2 );
+    policy.constraint  = ( uint32_t ) blockDuration;
+    policy.preemptible = 1;
+
+    return thread_policy_set( pthread_mach_thread_np( pthread_self()), THREAD_TIME_CONSTRAINT_POLICY,
+                              ( thread_policy_t ) &policy, THREAD_TIME_CONSTRAINT_POLICY_COUNT ) == KERN_SUCCESS;
+}
+
+#else
+
+bool WorkerPool::promoteToRealTime()
+{
+    // the middle of the range lies below the audio threads of most hosts (which run near its top),
+    // when the real-time limit of the user lies below it, the lowest real-time priority is attempted
+
+    int lowest  = sched_get_priority_min( SCHED_FIFO );
+    int highest = sched_get_priority_max( SCHED_FIFO );
+
+    for ( int priority : { ( lowest + highest ) / 2, lowest }) {
+        sched_param parameters {};
+        parameters.sched_priority = priority;
+
+        if ( pthread_setschedparam( pthread_self(), SCHED_FIFO, &parameters ) == 0 ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
+
+/* semaphore */
+
+#if defined( _WIN32 )
+
+WorkerPool::Semaphore::Semaphore()  { handle = CreateSemaphore( nullptr, 0, 0x7FFFFFFF, nullptr ); }
+WorkerPool::Semaphore::~Semaphore() { CloseHandle(( HANDLE ) handle ); }
+void WorkerPool::Semaphore::post()  { ReleaseSemaphore(( HANDLE ) handle, 1, nullptr ); }
+void WorkerPool::Semaphore::wait()  { WaitForSingleObject(( HANDLE ) handle, INFINITE ); }
+
+#elif defined( __APPLE__ )
+
+WorkerPool::Semaphore::Semaphore()  { handle = ( void* ) dispatch_semaphore_create( 0 ); }
+WorkerPool::Semaphore::~Semaphore() { dispatch_release(( dispatch_semaphore_t ) handle ); }
+void WorkerPool::Semaphore::post()  { dispatch_semaphore_signal(( dispatch_semaphore_t ) handle ); }
+void WorkerPool::Semaphore::wait()  { dispatch_semaphore_wait(( dispatch_semaphore_t ) handle, DISPATCH_TIME_FOREVER ); }
+
+#else
+
+WorkerPool::Semaphore::Semaphore()  { handle = new sem_t; sem_init(( sem_t* ) handle, 0, 0 ); }
+WorkerPool::Semaphore::~Semaphore() { sem_destroy(( sem_t* ) handle ); delete ( sem_t* ) handle; }
+void WorkerPool::Semaphore::post()  { sem_post(( sem_t* ) handle ); }
+void WorkerPool::Semaphore::wait()  { while ( sem_wait(( sem_t* ) handle ) != 0 ) {} }
+
+#endif
+
+} // E.O. namespace Igorski
@@ -0,0 +1,116 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __WORKERPOOL_HEADER__
+#define __WORKERPOOL_HEADER__
+
+#include <atomic>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+namespace Igorski {
+
+    /**
+     * Small pool of worker threads executing the tasks of a single job at a time (e.g. rendering
+     * the parts of the multi-timbral mode), where the thread that submits the job (the audio thread)
+     * executes tasks alongside the workers until all have completed (fork/join).
+     * Submitting a job neither allocates nor locks: the tasks are claimed through a single atomic.
+     * Workers spin for a short while after each job (as the next usually follows shortly, e.g. for
+     * the next sub-block) after which they sleep on a semaphore until they are woken by a new job.
+     * Posting the semaphore is a system call, which the submitting thread only makes when workers
+     * have gone to sleep (e.g. for the first job of a block when blocks are further apart than the
+     * spin duration), jobs submitted while the workers are still spinning make no system calls.
+     * Threads are only started and stopped outside of the audio thread (e.g. on activation)
+     *
+     * As the audio thread awaits the tasks claimed by the workers, these run at real-time priority
+     * (SCHED_FIFO on Linux, time critical on Windows and a time constraint policy on macOS) so they are
+     * not preempted halfway through a task. When the system denies this (e.g. Linux without a real-time
+     * limit for the user) the workers run at normal priority, in which case the audio thread yields the
+     * processor once a task takes longer than expected, letting a preempted worker resume
+     */
+    class WorkerPool {
+
+        public:
+            typedef void ( *Task )( void* context, int index );
+
+            WorkerPool();
+            ~WorkerPool();
+
+            // starts given amount of worker threads / stops all worker threads
+            // period is the duration (in seconds) of the blocks the jobs are submitted for, which
+            // platforms that schedule real-time threads by their period use to do so (macOS)
+            void start( int workerAmount, double period );
+            void stop();
+
+            int getWorkerAmount() { return ( int ) workers.size(); }
+
+            // executes given task for each index in the 0 - taskAmount range, returning once all have completed.
+            // Without workers, all tasks execute on the calling thread
+            void run( int taskAmount, Task task, void* context );
+
+        private:
+
+            // the duration for which a worker awaits the next job before going to sleep
+            static constexpr int SPIN_MICROSECONDS = 100;
+
+            class Semaphore {
+                public:
+                    Semaphore();
+                    ~Semaphore();
+
+                    void post();
+                    void wait();
+
+                private:
+                    void* handle;
+            };
+
+            std::vector<std::thread> workers;
+            Semaphore semaphore;
+
+            // the current job: its generation (upper 32 bits) and amount of unclaimed tasks (lower 32 bits),
+            // the amount of tasks that have yet to complete and the amount of sleeping workers
+
+            std::atomic<uint64_t> work;
+            std::atomic<int> pending;
+            std::atomic<int> sleeping;
+            std::atomic<bool> running;
+            double period;
+
+            // properties of the current job, these are only written while no tasks can be claimed
+
+            Task task;
+            void* context;
+            int taskAmount;
+
+            void workerLoop();
+
+            // raises the priority of the calling (worker) thread to real-time, returns false when denied
+            bool promoteToRealTime();
+
+            // executes a single unclaimed task of the current job, returns false when there was none
+            bool claim();
+    };
+}
+
+#endif
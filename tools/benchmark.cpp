@@ -0,0 +1,561 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "../src/global.h"
+#include "../src/synth.h"
+#include "../src/filter.h"
+#include "../src/svfilter.h"
+#include "../src/ringmod.h"
+#include "../src/paramids.h"
+#include "offlinehost.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Igorski;
+
+/**
+ * vstsid_benchmark: measures the cost of the DSP building blocks
+ * (Synthesizer::synthesize, Filter::process and RingModulator::apply)
+ * across a sweep of voice counts, buffer sizes, sample precisions and synthesis
+ * modes. Results are written as JSON and can be compared against a previously
+ * saved baseline to flag regressions
+ */
+
+namespace {
+
+    const int SAMPLE_RATE  = 44100;
+
+    const int VOICE_COUNTS[] = { 1, 2, 4, 8, 16, 32, 64 };
+    const int BUFFER_SIZES[] = { 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+
+    struct Options {
+        std::string outputPath;
+        std::string baselinePath;
+        std::string filter;       // only run benchmarks whose name contains this string
+        int samplesPerRun = 16384;
+        int runs          = 5;
+        double threshold  = 10.0; // in percent, the allowed slowdown before flagging a regression
+    };
+
+    struct Result {
+        std::string name;
+        int voices;
+        double nsPerSample;
+        double nsPerVoiceSample;
+    };
+
+    // a single benchmark case: prepare() is invoked outside of the timed region
+    // and returns the function that renders a single block
+
+    typedef std::function<void()> RenderFn;
+    typedef std::function<RenderFn()> PrepareFn;
+
+    // the DSP building blocks process a single (mono) channel, which the processor copies into all output channels
+
+    template <typename SampleType>
+    struct Buffer {
+        Buffer( int bufferSize ) : size( bufferSize ) {
+            samples = new SampleType[ bufferSize ]();
+        }
+        ~Buffer() {
+            delete[] samples;
+        }
+        // fill with a deterministic, non-silent signal
+        void fill() {
+            for ( int i = 0; i < size; ++i ) {
+                samples[ i ] = ( SampleType ) ((( i * 7919 ) % 2000 ) / 1000.0 - 1.0 );
+            }
+        }
+        SampleType* samples;
+        int size;
+    };
+
+    // time the rendering of (at least) the requested amount of samples, the fastest of all runs is returned
+
+    double measure( const PrepareFn& prepare, int bufferSize, const Options& options )
+    {
+        int blocks = std::max( 1, options.samplesPerRun / bufferSize );
+        double best = 0.0;
+
+        for ( int run = 0; run < options.runs; ++run )
+        {
+            RenderFn render = prepare();
+            render(); // warm up
+
+            auto start = std::chrono::steady_clock::now();
+            for ( int i = 0; i < blocks; ++i ) {
+                render();
+            }
+            double ns = std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - start ).count();
+            ns /= ( double ) blocks * bufferSize;
+
+            if ( run == 0 || ns < best ) {
+                best = ns;
+            }
+        }
+        return best;
+    }
+
+    template <typename SampleType>
+    PrepareFn prepareSynth( int voices, int bufferSize, bool triangle, bool arpeggiate, bool glide, bool bandLimited = false )
+    {
+        return [ = ]() -> RenderFn {
+            auto synth   = std::make_shared<Synthesizer>();
+            auto buffer  = std::make_shared<Buffer<SampleType>>( bufferSize );
+
+            // the triangle waveform is used when the ring modulator is active
+            float ringModRate = triangle ? 0.1f : 0.f;
+
+            synth->init( SAMPLE_RATE, 120.0 );
+            synth->updateProperties( 0.f, 0.f, 0.5f, 1.f, ringModRate, 1.f, 0.f );
+            synth->setBandLimited( bandLimited );
+
+            if ( arpeggiate ) {
+                // holding ARPEGGIATOR_THRESHOLD or more notes arpeggiates
+                for ( int i = 0; i < voices; ++i ) {
+                    synth->noteOn( 36 + i, 1.f, 0.f );
+                }
+            } else {
+                // released notes do not count towards the arpeggiator threshold, keep
+                // all but one note in their (one second long) release phase
+                for ( int i = 0; i < voices - 1; ++i ) {
+                    synth->noteOn( 36 + i, 1.f, 0.f );
+                }
+                for ( int i = 0; i < voices - 1; ++i ) {
+                    synth->noteOff( 36 + i );
+                }
+                synth->noteOn( 36 + voices - 1, 1.f, 0.f );
+            }
+
+            if ( glide ) {
+                // glide the first held note towards a new pitch over one second
+                synth->updateProperties( 0.f, 0.f, 0.5f, 1.f, ringModRate, 1.f, 1.f );
+                synth->noteOn( 110, 1.f, 0.f );
+            }
+            return [ synth, buffer, bufferSize ]() {
+                synth->synthesize<SampleType>( buffer->samples, bufferSize );
+            };
+        };
+    }
+
+    template <typename SampleType>
+    PrepareFn prepareFilter( int bufferSize, bool lfo, int mode = FilterModes::BIQUAD_LOW_PASS )
+    {
+        return [ = ]() -> RenderFn {
+            auto filter  = std::make_shared<Filter>(( float ) SAMPLE_RATE );
+            auto buffer  = std::make_shared<Buffer<SampleType>>( bufferSize );
+
+            filter->setMode( mode );
+            filter->updateProperties( 0.5f, 0.5f, lfo ? 0.5f : 0.f, 1.f );
+            buffer->fill();
+
+            return [ filter, buffer, bufferSize ]() {
+                filter->process<SampleType>( buffer->samples, bufferSize );
+            };
+        };
+    }
+
+    // four channels low-pass filtered by the state variable filter, either with all channels in the lanes of a single
+    // filter (Vector is SIMD::float4, the samples of all channels interleaved in structure-of-arrays form) or as four
+    // separate filters (Vector is float). When swept, the coefficients are ramped towards a new cutoff each control period
+
+    template <typename Vector>
+    PrepareFn prepareFilterChannels( int bufferSize, bool sweep )
+    {
+        return [ = ]() -> RenderFn {
+            const int filterAmount = SIMD::LANES * sizeof( float ) / sizeof( Vector );
+
+            auto filters = std::make_shared<std::vector<StateVariableFilter<Vector>>>(
+                filterAmount, StateVariableFilter<Vector>(( float ) SAMPLE_RATE )
+            );
+            auto samples = std::make_shared<std::vector<Vector>>( filterAmount * bufferSize );
+
+            for ( int i = 0; i < filterAmount * bufferSize; ++i ) {
+                ( *samples )[ i ] = Vector(( float ) ((( i * 7919 ) % 2000 ) / 1000.0 - 1.0 ));
+            }
+
+            return [ filters, samples, bufferSize, filterAmount, sweep ]() {
+                for ( int f = 0; f < filterAmount; ++f ) {
+                    StateVariableFilter<Vector>& filter = ( *filters )[ f ];
+                    Vector* channels = samples->data() + f * bufferSize;
+
+                    if ( !sweep ) {
+                        filter.template process<SVFModes::LOW_PASS, false>( channels, bufferSize );
+                        continue;
+                    }
+                    for ( int i = 0; i < bufferSize; i += Filter::CONTROL_RATE ) {
+                        int length = std::min( Filter::CONTROL_RATE, bufferSize - i );
+                        filter.rampCoefficients( Vector(( i / Filter::CONTROL_RATE ) % 2 ? 500.f : 2000.f ), Vector( 0.5f ), length );
+                        filter.template process<SVFModes::LOW_PASS, true>( channels + i, length );
+                    }
+                }
+            };
+        };
+    }
+
+    template <typename SampleType>
+    PrepareFn prepareRingModulator( int bufferSize )
+    {
+        return [ = ]() -> RenderFn {
+            auto ringModulator = std::make_shared<Steinberg::Vst::mda::RingModulator>();
+            auto buffer        = std::make_shared<Buffer<SampleType>>( bufferSize );
+
+            ringModulator->setRate( 0.1f );
+            buffer->fill();
+
+            return [ ringModulator, buffer, bufferSize ]() {
+                ringModulator->apply<SampleType>( buffer->samples, bufferSize );
+            };
+        };
+    }
+
+    // the processor filtering either its output (summed) or each voice individually (where the cutoff of each voice
+    // follows its envelope), all but one of the voices are in their release phase so that these do not arpeggiate
+
+    PrepareFn prepareVoiceFilter( int voices, int bufferSize, bool doublePrecision, bool perVoice )
+    {
+        return [ = ]() -> RenderFn {
+            auto host = std::make_shared<OfflineHost>(( double ) SAMPLE_RATE, bufferSize, doublePrecision );
+
+            host->setParameter( kReleaseId, 0, 1.0 );
+            host->setParameter( kResonanceId, 0, 0.5 );
+            host->setParameter( kLFORateId, 0, 0.5 );
+            host->setParameter( kVoiceFilterId, 0, perVoice ? 1.0 : 0.0 );
+            host->setParameter( kFilterEnvelopeId, 0, 0.5 );
+            host->process( bufferSize );
+
+            for ( int16 i = 0; i < voices - 1; ++i ) {
+                host->noteOn( 0, 36 + i, 1.f );
+                host->noteOff( 0, 36 + i );
+            }
+            host->noteOn( 0, 36 + voices - 1, 1.f );
+
+            return [ host, bufferSize ]() {
+                host->process( bufferSize );
+            };
+        };
+    }
+
+    // the processor with the cutoff, resonance and ring modulator rate automated by given amount of points per block
+    // (these are ramped in between, where each point splits the block), sweeping back and forth each second
+
+    PrepareFn prepareAutomation( int points, int bufferSize, bool doublePrecision )
+    {
+        return [ = ]() -> RenderFn {
+            auto host     = std::make_shared<OfflineHost>(( double ) SAMPLE_RATE, bufferSize, doublePrecision );
+            auto position = std::make_shared<int64_t>( 0 );
+
+            host->setParameter( kRingModRateId, 0, 0.05 );
+            host->process( bufferSize );
+
+            for ( int16 i = 0; i < 4; ++i ) {
+                host->noteOn( 0, 36 + i * 7, 1.f );
+            }
+
+            return [ host, position, points, bufferSize ]() {
+                for ( int i = 0; i < points; ++i ) {
+                    int32 offset = ( int32 ) (( i + 1 ) * ( int64_t ) bufferSize / points ) - 1;
+                    double value = 0.5 + 0.4 * sin( 3.141592653589793 * ( *position + offset ) / SAMPLE_RATE );
+
+                    host->setParameter( kCutoffId,      offset, value );
+                    host->setParameter( kResonanceId,   offset, value );
+                    host->setParameter( kRingModRateId, offset, 0.05 * value );
+                }
+                host->process( bufferSize );
+                *position += bufferSize;
+            };
+        };
+    }
+
+    // the processor in multi-timbral mode, with each part holding four notes on its own MIDI channel
+    // the parts are rendered in parallel by the workers (started on activation) unless these are disabled
+
+    PrepareFn prepareParts( int parts, int bufferSize, bool doublePrecision, bool workers )
+    {
+        return [ = ]() -> RenderFn {
+            auto host = std::make_shared<OfflineHost>(( double ) SAMPLE_RATE, bufferSize, doublePrecision );
+
+            host->setParameter( kMultiTimbralId, 0, 1.0 );
+            host->process( bufferSize );
+
+            if ( !workers ) {
+                host->getProcessor()->setMaxWorkers( 0 );
+                host->restart();
+            }
+            for ( int16 part = 0; part < parts; ++part ) {
+                for ( int16 i = 0; i < 4; ++i ) {
+                    host->noteOn( 0, 36 + part + i * 12, 1.f, part );
+                }
+            }
+            return [ host, bufferSize ]() {
+                host->process( bufferSize );
+            };
+        };
+    }
+
+    void run( std::vector<Result>& results, const Options& options, const std::string& name,
+              int voices, int bufferSize, const PrepareFn& prepare )
+    {
+        if ( !options.filter.empty() && name.find( options.filter ) == std::string::npos ) {
+            return;
+        }
+        double nsPerSample = measure( prepare, bufferSize, options );
+        results.push_back({ name, voices, nsPerSample, nsPerSample / voices });
+
+        fprintf( stderr, "%-64s %10.2f ns/sample %10.2f ns/voice/sample\n", name.c_str(), nsPerSample, nsPerSample / voices );
+    }
+
+    template <typename SampleType>
+    void runAll( std::vector<Result>& results, const Options& options, const char* precision )
+    {
+        for ( int bufferSize : BUFFER_SIZES )
+        {
+            std::string suffix = "/buffer:" + std::to_string( bufferSize ) + "/" + precision;
+
+            for ( int voices : VOICE_COUNTS ) {
+                for ( int triangle = 0; triangle < 2; ++triangle ) {
+                    for ( int arpeggiate = 0; arpeggiate < 2; ++arpeggiate ) {
+                        for ( int glide = 0; glide < 2; ++glide ) {
+                            std::string name = "synth/voices:" + std::to_string( voices ) +
+                                               ( triangle   ? "/triangle"  : "/pwm" ) +
+                                               ( arpeggiate ? "/arpeggio"  : "/poly" ) +
+                                               ( glide      ? "/glide:on"  : "/glide:off" ) + suffix;
+
+                            run( results, options, name, voices, bufferSize,
+                                 prepareSynth<SampleType>( voices, bufferSize, triangle, arpeggiate, glide ));
+                        }
+                    }
+                    // the added cost of the band-limited oscillators
+
+                    std::string name = "synth/voices:" + std::to_string( voices ) +
+                                       ( triangle ? "/triangle" : "/pwm" ) + "/poly/glide:off/band-limited" + suffix;
+
+                    run( results, options, name, voices, bufferSize,
+                         prepareSynth<SampleType>( voices, bufferSize, triangle, false, false, true ));
+                }
+            }
+            run( results, options, "filter/lfo:off" + suffix, 1, bufferSize, prepareFilter<SampleType>( bufferSize, false ));
+            run( results, options, "filter/lfo:on"  + suffix, 1, bufferSize, prepareFilter<SampleType>( bufferSize, true ));
+
+            const char* svfModes[] = { "low-pass", "band-pass", "high-pass" };
+            for ( int mode = 0; mode < 3; ++mode ) {
+                for ( int lfo = 0; lfo < 2; ++lfo ) {
+                    std::string name = std::string( "filter/svf:" ) + svfModes[ mode ] + ( lfo ? "/lfo:on" : "/lfo:off" ) + suffix;
+                    run( results, options, name, 1, bufferSize, prepareFilter<SampleType>( bufferSize, lfo, FilterModes::SVF_LOW_PASS + mode ));
+                }
+            }
+            run( results, options, "ringmod" + suffix, 1, bufferSize, prepareRingModulator<SampleType>( bufferSize ));
+
+            bool doublePrecision = sizeof( SampleType ) == sizeof( double );
+
+            // the channels of the state variable filter are single precision (as are the vector lanes)
+
+            if ( !doublePrecision ) {
+                for ( int sweep = 0; sweep < 2; ++sweep ) {
+                    std::string name = std::string( "filter/svf:channels:4" ) + ( sweep ? "/sweep:on" : "/sweep:off" );
+                    run( results, options, name + "/lanes:simd" + suffix, 4, bufferSize, prepareFilterChannels<SIMD::float4>( bufferSize, sweep ));
+                    run( results, options, name + "/lanes:off"  + suffix, 4, bufferSize, prepareFilterChannels<float>( bufferSize, sweep ));
+                }
+            }
+
+            for ( int voices : VOICE_COUNTS ) {
+                for ( int perVoice = 0; perVoice < 2; ++perVoice ) {
+                    std::string name = "voice-filter/voices:" + std::to_string( voices ) + ( perVoice ? "/per-voice" : "/summed" ) + suffix;
+                    run( results, options, name, voices, bufferSize, prepareVoiceFilter( voices, bufferSize, doublePrecision, perVoice ));
+                }
+            }
+
+            for ( int points : { 0, 1, 16 }) {
+                std::string name = "automation/points:" + std::to_string( points ) + suffix;
+                run( results, options, name, 4, bufferSize, prepareAutomation( points, bufferSize, doublePrecision ));
+            }
+
+            for ( int parts : { 2, 4, 16 }) {
+                for ( int workers = 0; workers < 2; ++workers ) {
+                    std::string name = "parts:" + std::to_string( parts ) + ( workers ? "/workers:on" : "/workers:off" ) + suffix;
+                    run( results, options, name, parts * 4, bufferSize, prepareParts( parts, bufferSize, doublePrecision, workers ));
+                }
+            }
+        }
+    }
+
+    bool writeResults( const std::vector<Result>& results, const Options& options )
+    {
+        FILE* file = options.outputPath.empty() ? stdout : fopen( options.outputPath.c_str(), "w" );
+
+        if ( file == nullptr ) {
+            return false;
+        }
+
+        // one benchmark per line, this keeps the file diff-friendly and easy to read back
+
+        fprintf( file, "{\n  \"samplesPerRun\": %d,\n  \"runs\": %d,\n  \"benchmarks\": [\n", options.samplesPerRun, options.runs );
+        for ( size_t i = 0; i < results.size(); ++i ) {
+            const Result& result = results[ i ];
+            fprintf( file, "    { \"name\": \"%s\", \"voices\": %d, \"nsPerSample\": %.4f, \"nsPerVoiceSample\": %.4f }%s\n",
+                     result.name.c_str(), result.voices, result.nsPerSample, result.nsPerVoiceSample,
+                     i + 1 < results.size() ? "," : "" );
+        }
+        fprintf( file, "  ]\n}\n" );
+
+        if ( file != stdout ) {
+            fclose( file );
+        }
+        return true;
+    }
+
+    // reads the name and nsPerSample fields of a previously written results file
+
+    bool readBaseline( const std::string& path, std::map<std::string, double>& baseline )
+    {
+        std::ifstream file( path );
+        if ( !file.good()) {
+            return false;
+        }
+        const std::string nameKey  = "\"name\": \"";
+        const std::string valueKey = "\"nsPerSample\": ";
+        std::string line;
+
+        while ( std::getline( file, line ))
+        {
+            size_t namePos  = line.find( nameKey );
+            size_t valuePos = line.find( valueKey );
+
+            if ( namePos == std::string::npos || valuePos == std::string::npos ) {
+                continue;
+            }
+            namePos += nameKey.size();
+            std::string name = line.substr( namePos, line.find( '"', namePos ) - namePos );
+            baseline[ name ] = atof( line.c_str() + valuePos + valueKey.size());
+        }
+        return true;
+    }
+
+    // returns the amount of benchmarks that are slower than the baseline by more than the threshold
+
+    int compare( const std::vector<Result>& results, const std::map<std::string, double>& baseline, const Options& options )
+    {
+        int regressions = 0;
+
+        for ( const Result& result : results )
+        {
+            auto it = baseline.find( result.name );
+            if ( it == baseline.end() || it->second <= 0.0 ) {
+                continue;
+            }
+            double change = ( result.nsPerSample / it->second - 1.0 ) * 100.0;
+
+            if ( change > options.threshold ) {
+                fprintf( stderr, "REGRESSION %-64s %10.2f -> %10.2f ns/sample (%+.1f%%)\n",
+                         result.name.c_str(), it->second, result.nsPerSample, change );
+                ++regressions;
+            } else if ( change < -options.threshold ) {
+                fprintf( stderr, "IMPROVED   %-64s %10.2f -> %10.2f ns/sample (%+.1f%%)\n",
+                         result.name.c_str(), it->second, result.nsPerSample, change );
+            }
+        }
+        fprintf( stderr, "%d regression(s) beyond %.1f%% against baseline\n", regressions, options.threshold );
+
+        return regressions;
+    }
+
+    void printUsage( const char* executable )
+    {
+        fprintf( stderr,
+            "Usage: %s [options]\n\n"
+            "  --output FILE     write JSON results to FILE (default stdout)\n"
+            "  --compare FILE    compare results against a previously saved JSON baseline\n"
+            "  --threshold PCT   allowed slowdown in percent before flagging a regression (default 10)\n"
+            "  --filter TEXT     only run benchmarks whose name contains TEXT\n"
+            "  --samples COUNT   amount of samples rendered per run (default 16384)\n"
+            "  --runs COUNT      amount of runs per benchmark, the fastest is reported (default 5)\n",
+            executable
+        );
+    }
+
+    bool parseOptions( int argc, char** argv, Options& options )
+    {
+        for ( int i = 1; i < argc; ++i )
+        {
+            std::string arg = argv[ i ];
+            bool hasValue   = i + 1 < argc;
+
+            if ( arg == "--output" && hasValue ) {
+                options.outputPath = argv[ ++i ];
+            } else if ( arg == "--compare" && hasValue ) {
+                options.baselinePath = argv[ ++i ];
+            } else if ( arg == "--threshold" && hasValue ) {
+                options.threshold = atof( argv[ ++i ]);
+            } else if ( arg == "--filter" && hasValue ) {
+                options.filter = argv[ ++i ];
+            } else if ( arg == "--samples" && hasValue ) {
+                options.samplesPerRun = atoi( argv[ ++i ]);
+            } else if ( arg == "--runs" && hasValue ) {
+                options.runs = atoi( argv[ ++i ]);
+            } else {
+                fprintf( stderr, "Unknown or incomplete argument: %s\n\n", arg.c_str());
+                return false;
+            }
+        }
+        return options.samplesPerRun > 0 && options.runs > 0;
+    }
+}
+
+int main( int argc, char** argv )
+{
+    Options options;
+
+    if ( !parseOptions( argc, argv, options )) {
+        printUsage( argv[ 0 ]);
+        return 1;
+    }
+
+    // the DSP classes read the sample rate from the global configuration
+    VST::SAMPLE_RATE = ( float ) SAMPLE_RATE;
+
+    std::map<std::string, double> baseline;
+    if ( !options.baselinePath.empty() && !readBaseline( options.baselinePath, baseline )) {
+        fprintf( stderr, "Could not read baseline %s\n", options.baselinePath.c_str());
+        return 1;
+    }
+
+    std::vector<Result> results;
+
+    runAll<float> ( results, options, "float" );
+    runAll<double>( results, options, "double" );
+
+    if ( !writeResults( results, options )) {
+        fprintf( stderr, "Could not write results to %s\n", options.outputPath.c_str());
+        return 1;
+    }
+    return ( !baseline.empty() && compare( results, baseline, options ) > 0 ) ? 2 : 0;
+}
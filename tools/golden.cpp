@@ -0,0 +1,608 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "offlinehost.h"
+#include "wavereader.h"
+#include "wavewriter.h"
+#include "../src/global.h"
+#include "../src/filter.h"
+#include "../src/paramids.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#if defined( _WIN32 )
+#include <direct.h>
+#endif
+
+using namespace Igorski;
+
+/**
+ * vstsid_golden: renders a fixed corpus of note/parameter scenarios through the
+ * VSTSID processor and compares the output against previously recorded reference
+ * renders. Use --record prior to making changes to the DSP code and --verify
+ * afterwards to assert the output remained the same (within the given tolerance)
+ */
+
+namespace {
+
+    struct Action {
+        enum Type { NOTE_ON, NOTE_OFF, PARAMETER };
+
+        double time; // in seconds
+        Type type;
+        int id;       // pitch or parameter id
+        double value; // velocity or normalized parameter value
+        int channel;  // MIDI channel of a note event
+    };
+
+    struct Scenario {
+        std::string name;
+        double duration; // in seconds
+        bool doublePrecision;
+        std::vector<Action> actions;
+    };
+
+    Action on( double time, int pitch, double velocity = 0.8, int channel = 0 ) { return { time, Action::NOTE_ON, pitch, velocity, channel }; }
+    Action off( double time, int pitch, int channel = 0 ) { return { time, Action::NOTE_OFF, pitch, 0.0, channel }; }
+    Action param( double time, int id, double value ) { return { time, Action::PARAMETER, id, value, 0 }; }
+
+    // envelope properties shared by most scenarios
+
+    std::vector<Action> envelope( double attack, double decay, double sustain, double release )
+    {
+        return { param( 0, kAttackId, attack ), param( 0, kDecayId, decay ), param( 0, kSustainId, sustain ), param( 0, kReleaseId, release ) };
+    }
+
+    std::vector<Scenario> createScenarios()
+    {
+        std::vector<Scenario> scenarios;
+
+        auto add = [ &scenarios ]( const std::string& name, double duration, std::vector<Action> setup, std::vector<Action> actions, bool doublePrecision = false ) {
+            setup.insert( setup.end(), actions.begin(), actions.end());
+            std::stable_sort( setup.begin(), setup.end(), []( const Action& a, const Action& b ) { return a.time < b.time; });
+            scenarios.push_back({ name, duration, doublePrecision, setup });
+        };
+
+        add( "envelope", 1.4, envelope( 0.1, 0.3, 0.6, 0.3 ), {
+            on( 0.0, 57 ), off( 0.8, 57 )
+        });
+
+        // cross the arpeggiator threshold up and down (see Synthesizer::handleNoteAmountChange)
+
+        std::vector<Action> arpeggio = {
+            on( 0.0, 48 ), on( 0.2, 52 ), on( 0.4, 55 ), on( 0.6, 59 ),
+            off( 1.0, 55 ), off( 1.2, 59 ), on( 1.4, 62 ),
+            off( 2.0, 48 ), off( 2.0, 52 ), off( 2.0, 62 )
+        };
+        add( "arpeggio-threshold", 2.5, envelope( 0.0, 0.5, 0.7, 0.2 ), arpeggio );
+        add( "arpeggio-threshold-double", 2.5, envelope( 0.0, 0.5, 0.7, 0.2 ), arpeggio, true );
+
+        // legato notes glide and return to the previous pitch on release (see Synthesizer::restorePitchOnRelease)
+
+        std::vector<Action> glide = envelope( 0.0, 0.5, 0.8, 0.2 );
+        glide.push_back( param( 0, kPortamentoId, 0.1 ));
+
+        add( "portamento", 2.0, glide, {
+            on( 0.0, 48 ), on( 0.3, 55 ), on( 0.6, 60 ),
+            off( 0.9, 60 ), off( 1.2, 55 ), off( 1.5, 48 )
+        });
+
+        add( "release-tails", 2.0, envelope( 0.0, 0.2, 0.7, 0.6 ), {
+            on( 0.0, 45 ), on( 0.0, 52 ), on( 0.0, 57 ), on( 0.0, 64 ),
+            off( 0.3, 64 ), off( 0.5, 57 ), off( 0.7, 52 ), off( 0.9, 45 )
+        });
+
+        // dense polyphony: released notes do not arpeggiate, leaving many simultaneous voices
+
+        std::vector<Action> polyphony;
+        for ( int i = 0; i < 12; ++i ) {
+            polyphony.push_back( on( i * 0.04, 40 + i * 3, 0.3 + 0.05 * i ));
+            polyphony.push_back( off( i * 0.04 + 0.02, 40 + i * 3 ));
+        }
+        add( "polyphony", 1.5, envelope( 0.0, 0.3, 0.5, 0.9 ), polyphony );
+
+        // more notes than the four allowed voices, mixing held, released and differently sounding
+        // notes so each voice stealing policy (see VoiceStealing) picks a different voice to steal
+
+        const double stealingVelocities[] = { 0.9, 0.8, 0.3, 0.9, 0.5, 0.7, 0.4, 0.9 };
+        std::vector<Action> stealingNotes;
+        for ( int i = 0; i < 8; ++i ) {
+            stealingNotes.push_back( on( i * 0.05, 45 + i * 4, stealingVelocities[ i ] ));
+            stealingNotes.push_back( off( i == 1 ? 0.12 : 0.8, 45 + i * 4 ));
+        }
+
+        const char* stealingPolicies[] = { "voice-stealing-released-first", "voice-stealing-oldest", "voice-stealing-quietest" };
+        for ( int policy = 0; policy < VST::VOICE_STEALING_POLICIES; ++policy ) {
+            std::vector<Action> stealing = envelope( 0.0, 0.3, 0.5, 0.9 );
+            stealing.push_back( param( 0, kMaxVoicesId, 3.0 / ( VST::MAX_POLYPHONY - 1 )));
+            stealing.push_back( param( 0, kVoiceStealingId, policy / ( double ) ( VST::VOICE_STEALING_POLICIES - 1 )));
+
+            add( stealingPolicies[ policy ], 1.5, stealing, stealingNotes );
+        }
+
+        std::vector<Action> ringMod = envelope( 0.0, 0.5, 0.5, 0.2 );
+        ringMod.push_back( param( 0, kRingModRateId, 0.05 ));
+
+        add( "ring-mod", 1.2, ringMod, {
+            on( 0.0, 57 ), on( 0.25, 64 ), off( 0.6, 57 ), off( 0.8, 64 )
+        });
+
+        // toggling the ring modulator switches waveforms mid-note
+
+        add( "ring-mod-toggle", 1.2, ringMod, {
+            on( 0.0, 50 ), param( 0.4, kRingModRateId, 0.0 ), param( 0.8, kRingModRateId, 0.2 ), off( 1.0, 50 )
+        });
+
+        // band-limited oscillators at high pitches (where the naive waveforms alias the most), for both waveforms
+
+        std::vector<Action> bandLimited = envelope( 0.0, 0.5, 0.8, 0.2 );
+        bandLimited.push_back( param( 0, kBandLimitedId, 1.0 ));
+
+        add( "band-limited", 1.2, bandLimited, {
+            on( 0.0, 96 ), on( 0.1, 103 ), param( 0.5, kRingModRateId, 0.2 ), off( 0.9, 96 ), off( 0.9, 103 )
+        });
+
+        std::vector<Action> lfo = envelope( 0.05, 0.5, 0.8, 0.3 );
+        lfo.push_back( param( 0, kCutoffId, 0.4 ));
+        lfo.push_back( param( 0, kResonanceId, 0.5 ));
+        lfo.push_back( param( 0, kLFORateId, 0.3 ));
+        lfo.push_back( param( 0, kLFODepthId, 0.8 ));
+
+        add( "lfo-sweep", 2.0, lfo, {
+            on( 0.0, 45 ), param( 0.8, kLFORateId, 0.7 ), param( 1.2, kLFODepthId, 0.3 ), off( 1.5, 45 )
+        });
+
+        // the same sweep through each response of the state variable filter (see FilterModes)
+
+        const char* filterModes[] = { "svf-low-pass", "svf-band-pass", "svf-high-pass" };
+        for ( int mode = FilterModes::SVF_LOW_PASS; mode < VST::FILTER_MODES; ++mode ) {
+            std::vector<Action> svf = lfo;
+            svf.push_back( param( 0, kFilterModeId, mode / ( double ) ( VST::FILTER_MODES - 1 )));
+
+            add( filterModes[ mode - FilterModes::SVF_LOW_PASS ], 2.0, svf, {
+                on( 0.0, 45 ), param( 0.8, kLFORateId, 0.7 ), param( 1.2, kLFODepthId, 0.3 ), off( 1.5, 45 )
+            });
+        }
+
+        // filtered per voice, where the cutoff of each voice follows its envelope (both for full groups of voices
+        // and the remaining voices rendered individually, see Synthesizer::renderVoices())
+
+        std::vector<Action> voiceFilter = envelope( 0.0, 0.3, 0.4, 0.9 );
+        voiceFilter.push_back( param( 0, kVoiceFilterId, 1.0 ));
+        voiceFilter.push_back( param( 0, kFilterEnvelopeId, 0.9 ));
+        voiceFilter.push_back( param( 0, kCutoffId, 0.6 ));
+        voiceFilter.push_back( param( 0, kResonanceId, 0.7 ));
+
+        add( "voice-filter", 1.5, voiceFilter, polyphony );
+
+        voiceFilter.push_back( param( 0, kFilterModeId, FilterModes::SVF_BAND_PASS / ( double ) ( VST::FILTER_MODES - 1 )));
+        voiceFilter.push_back( param( 0, kLFORateId, 0.3 ));
+
+        add( "voice-filter-band-pass", 1.5, voiceFilter, polyphony );
+
+        std::vector<Action> cutoff = envelope( 0.0, 0.5, 0.8, 0.2 );
+        cutoff.push_back( on( 0.0, 40 ));
+        for ( int i = 0; i <= 20; ++i ) {
+            cutoff.push_back( param( i * 0.05, kCutoffId, i / 20.0 ));
+        }
+        add( "cutoff-automation", 1.3, cutoff, { off( 1.05, 40 ) });
+
+        add( "pitch-bend", 1.2, envelope( 0.0, 0.5, 0.8, 0.2 ), {
+            on( 0.0, 60 ), param( 0.2, kMasterTuningId, 1.0 ), param( 0.5, kMasterTuningId, 0.0 ),
+            param( 0.8, kMasterTuningId, 0.5 ), off( 1.0, 60 )
+        });
+
+        // each MIDI channel plays its own part (with its own envelope and filter settings)
+
+        std::vector<Action> multiTimbral = envelope( 0.0, 0.5, 0.8, 0.2 );
+        multiTimbral.push_back( param( 0, kMultiTimbralId, 1.0 ));
+        multiTimbral.push_back( param( 0, VST::getPartParameterId( kAttackId, 1 ), 0.3 ));
+        multiTimbral.push_back( param( 0, VST::getPartParameterId( kCutoffId, 1 ), 0.3 ));
+        multiTimbral.push_back( param( 0, VST::getPartParameterId( kResonanceId, 1 ), 0.6 ));
+        multiTimbral.push_back( param( 0, VST::getPartParameterId( kRingModRateId, 2 ), 0.1 ));
+
+        add( "multi-timbral", 1.5, multiTimbral, {
+            on( 0.0, 48, 0.8, 0 ), on( 0.1, 60, 0.7, 1 ), on( 0.1, 64, 0.7, 1 ), on( 0.3, 67, 0.9, 2 ),
+            off( 0.6, 48, 0 ), param( 0.7, VST::getPartParameterId( kCutoffId, 1 ), 0.8 ),
+            off( 0.9, 60, 1 ), off( 0.9, 64, 1 ), off( 1.1, 67, 2 )
+        });
+
+        return scenarios;
+    }
+
+    // renders given scenario into non-interleaved channel buffers
+
+    bool render( const Scenario& scenario, double sampleRate, int32 blockSize, std::vector<std::vector<float>>& output )
+    {
+        OfflineHost host( sampleRate, blockSize, scenario.doublePrecision );
+
+        int64 totalSamples = ( int64 ) ( scenario.duration * sampleRate );
+        size_t actionIndex = 0;
+
+        output.assign( OfflineHost::NUM_CHANNELS, std::vector<float>( totalSamples ));
+
+        for ( int64 blockStart = 0; blockStart < totalSamples; blockStart += blockSize )
+        {
+            int32 numSamples = ( int32 ) std::min(( int64 ) blockSize, totalSamples - blockStart );
+
+            while ( actionIndex < scenario.actions.size())
+            {
+                const Action& action = scenario.actions[ actionIndex ];
+                int64 sample = ( int64 ) ( action.time * sampleRate );
+
+                if ( sample >= blockStart + numSamples ) {
+                    break;
+                }
+                int32 offset = ( int32 ) ( sample - blockStart );
+
+                switch ( action.type ) {
+                    case Action::NOTE_ON:
+                        host.noteOn( offset, action.id, ( float ) action.value, action.channel );
+                        break;
+                    case Action::NOTE_OFF:
+                        host.noteOff( offset, action.id, action.channel );
+                        break;
+                    case Action::PARAMETER:
+                        host.setParameter( action.id, offset, action.value );
+                        break;
+                }
+                ++actionIndex;
+            }
+            if ( !host.process( numSamples )) {
+                return false;
+            }
+            float** buffers = host.getOutput();
+            for ( int c = 0; c < OfflineHost::NUM_CHANNELS; ++c ) {
+                std::copy( buffers[ c ], buffers[ c ] + numSamples, output[ c ].begin() + blockStart );
+            }
+        }
+        return true;
+    }
+
+    /* comparison */
+
+    struct Tolerance {
+        enum Mode { EXACT, ULP, SPECTRAL };
+        Mode mode = EXACT;
+        double value = 0.0; // max ULP distance or max spectral difference (in dB relative to the reference)
+    };
+
+    // distance in units in the last place between two floats
+
+    int64_t ulpDistance( float a, float b )
+    {
+        if ( a == b ) {
+            return 0;
+        }
+        if ( std::isnan( a ) || std::isnan( b )) {
+            return INT64_MAX;
+        }
+        int32_t ia, ib;
+        memcpy( &ia, &a, sizeof( float ));
+        memcpy( &ib, &b, sizeof( float ));
+
+        // map the sign-magnitude representation onto a monotonic integer range
+        int64_t la = ia < 0 ? ( int64_t ) INT32_MIN - ia : ia;
+        int64_t lb = ib < 0 ? ( int64_t ) INT32_MIN - ib : ib;
+
+        return la > lb ? la - lb : lb - la;
+    }
+
+    void fft( std::vector<std::complex<double>>& data )
+    {
+        size_t n = data.size();
+
+        for ( size_t i = 1, j = 0; i < n; ++i ) {
+            size_t bit = n >> 1;
+            for ( ; j & bit; bit >>= 1 ) {
+                j ^= bit;
+            }
+            j ^= bit;
+            if ( i < j ) {
+                std::swap( data[ i ], data[ j ]);
+            }
+        }
+        for ( size_t length = 2; length <= n; length <<= 1 ) {
+            double angle = -2.0 * M_PI / length;
+            std::complex<double> step( cos( angle ), sin( angle ));
+            for ( size_t i = 0; i < n; i += length ) {
+                std::complex<double> w( 1.0 );
+                for ( size_t j = 0; j < length / 2; ++j ) {
+                    std::complex<double> u = data[ i + j ];
+                    std::complex<double> v = data[ i + j + length / 2 ] * w;
+                    data[ i + j ]              = u + v;
+                    data[ i + j + length / 2 ] = u - v;
+                    w *= step;
+                }
+            }
+        }
+    }
+
+    // the largest (over all frames) energy of the difference between the magnitude spectra
+    // of given signals, relative to the energy of the reference spectrum (in dB)
+
+    double spectralDifference( const std::vector<float>& reference, const std::vector<float>& output )
+    {
+        const size_t FRAME = 2048;
+        const size_t HOP   = FRAME / 2;
+        const double SILENCE = 1e-12;
+
+        double worst = -INFINITY;
+        std::vector<std::complex<double>> a( FRAME ), b( FRAME );
+
+        for ( size_t start = 0; start < reference.size(); start += HOP )
+        {
+            for ( size_t i = 0; i < FRAME; ++i ) {
+                double window = 0.5 - 0.5 * cos( 2.0 * M_PI * i / ( FRAME - 1 ));
+                size_t index  = start + i;
+                a[ i ] = index < reference.size() ? reference[ index ] * window : 0.0;
+                b[ i ] = index < output.size()    ? output[ index ] * window    : 0.0;
+            }
+            fft( a );
+            fft( b );
+
+            double signal = 0.0, difference = 0.0;
+            for ( size_t k = 0; k <= FRAME / 2; ++k ) {
+                double magnitude = std::abs( a[ k ]);
+                double delta     = magnitude - std::abs( b[ k ]);
+                signal     += magnitude * magnitude;
+                difference += delta * delta;
+            }
+            if ( signal < SILENCE && difference < SILENCE ) {
+                continue; // both silent
+            }
+            worst = std::max( worst, 10.0 * log10(( difference + 1e-30 ) / ( signal + 1e-30 )));
+        }
+        return worst;
+    }
+
+    bool compare( const std::vector<std::vector<float>>& reference, const std::vector<std::vector<float>>& output,
+                  const Tolerance& tolerance, std::string& report )
+    {
+        char text[ 256 ];
+
+        if ( reference.size() != output.size() || reference[ 0 ].size() != output[ 0 ].size()) {
+            report = "length or channel count differs from reference";
+            return false;
+        }
+
+        int64_t maxUlp   = 0;
+        double maxDelta  = 0.0;
+        double spectral  = -INFINITY;
+        int64_t firstDiff = -1;
+
+        for ( size_t c = 0; c < reference.size(); ++c )
+        {
+            for ( size_t i = 0; i < reference[ c ].size(); ++i ) {
+                int64_t ulp = ulpDistance( reference[ c ][ i ], output[ c ][ i ]);
+                if ( ulp > 0 && ( firstDiff < 0 || ( int64_t ) i < firstDiff )) {
+                    firstDiff = i;
+                }
+                maxUlp   = std::max( maxUlp, ulp );
+                maxDelta = std::max( maxDelta, ( double ) fabs( reference[ c ][ i ] - output[ c ][ i ]));
+            }
+            if ( tolerance.mode == Tolerance::SPECTRAL ) {
+                spectral = std::max( spectral, spectralDifference( reference[ c ], output[ c ]));
+            }
+        }
+
+        bool pass = true;
+        switch ( tolerance.mode ) {
+            case Tolerance::EXACT:
+                pass = maxUlp == 0;
+                break;
+            case Tolerance::ULP:
+                pass = maxUlp <= ( int64_t ) tolerance.value;
+                break;
+            case Tolerance::SPECTRAL:
+                pass = spectral <= tolerance.value;
+                break;
+        }
+
+        if ( tolerance.mode == Tolerance::SPECTRAL ) {
+            snprintf( text, sizeof( text ), "max ulp %lld, max abs diff %.3g, spectral diff %.1f dB",
+                      ( long long ) maxUlp, maxDelta, spectral );
+        } else if ( firstDiff >= 0 ) {
+            snprintf( text, sizeof( text ), "max ulp %lld, max abs diff %.3g, first difference at sample %lld",
+                      ( long long ) maxUlp, maxDelta, ( long long ) firstDiff );
+        } else {
+            snprintf( text, sizeof( text ), "identical" );
+        }
+        report = text;
+
+        return pass;
+    }
+
+    bool parseTolerance( const std::string& value, Tolerance& tolerance )
+    {
+        if ( value == "exact" ) {
+            tolerance.mode = Tolerance::EXACT;
+            return true;
+        }
+        if ( value.rfind( "ulp:", 0 ) == 0 ) {
+            tolerance.mode  = Tolerance::ULP;
+            tolerance.value = atof( value.c_str() + 4 );
+            return tolerance.value >= 0;
+        }
+        if ( value.rfind( "spectral:", 0 ) == 0 ) {
+            tolerance.mode  = Tolerance::SPECTRAL;
+            tolerance.value = atof( value.c_str() + 9 );
+            return true;
+        }
+        return false;
+    }
+
+    // creates given directory along with its missing parents, returns false when it does not exist afterwards
+
+    bool createDirectory( const std::string& path )
+    {
+        for ( size_t end = path.find_first_of( "/\\", 1 ); ; end = path.find_first_of( "/\\", end + 1 ))
+        {
+            std::string directory = path.substr( 0, end );
+#if defined( _WIN32 )
+            _mkdir( directory.c_str());
+#else
+            mkdir( directory.c_str(), 0755 );
+#endif
+            if ( end == std::string::npos ) {
+                break;
+            }
+        }
+        struct stat info;
+        return stat( path.c_str(), &info ) == 0 && ( info.st_mode & S_IFDIR ) != 0;
+    }
+
+    void printUsage( const char* executable )
+    {
+        fprintf( stderr,
+            "Usage: %s (--record DIR | --verify DIR | --list) [options]\n\n"
+            "  --record DIR        render all scenarios as reference files into DIR (created when missing)\n"
+            "  --verify DIR        render all scenarios and compare them against the references in DIR\n"
+            "  --list              list all scenarios\n"
+            "  --tolerance MODE    exact (default), ulp:N (max distance in units in the last place) or\n"
+            "                      spectral:DB (max spectral difference relative to the reference, e.g. spectral:-60)\n"
+            "  --scenario NAME     only process the scenario with given name\n"
+            "  --sample-rate RATE  sample rate in Hz (default 44100)\n"
+            "  --block-size SIZE   amount of samples rendered per process call (default 256), use\n"
+            "                      the same value for recording and verification\n",
+            executable
+        );
+    }
+}
+
+int main( int argc, char** argv )
+{
+    std::string recordDir, verifyDir, only;
+    Tolerance tolerance;
+    double sampleRate = 44100.0;
+    int32 blockSize   = 256;
+    bool list         = false;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        std::string arg = argv[ i ];
+        bool hasValue   = i + 1 < argc;
+
+        if ( arg == "--list" ) {
+            list = true;
+        } else if ( arg == "--record" && hasValue ) {
+            recordDir = argv[ ++i ];
+        } else if ( arg == "--verify" && hasValue ) {
+            verifyDir = argv[ ++i ];
+        } else if ( arg == "--tolerance" && hasValue && parseTolerance( argv[ i + 1 ], tolerance )) {
+            ++i;
+        } else if ( arg == "--scenario" && hasValue ) {
+            only = argv[ ++i ];
+        } else if ( arg == "--sample-rate" && hasValue ) {
+            sampleRate = atof( argv[ ++i ]);
+        } else if ( arg == "--block-size" && hasValue ) {
+            blockSize = atoi( argv[ ++i ]);
+        } else {
+            fprintf( stderr, "Unknown or incomplete argument: %s\n\n", arg.c_str());
+            printUsage( argv[ 0 ]);
+            return 1;
+        }
+    }
+
+    if (( recordDir.empty() == verifyDir.empty() && !list ) || sampleRate <= 0 || blockSize <= 0 ) {
+        printUsage( argv[ 0 ]);
+        return 1;
+    }
+
+    if ( !recordDir.empty() && !createDirectory( recordDir )) {
+        fprintf( stderr, "Could not create the reference directory %s\n", recordDir.c_str());
+        return 1;
+    }
+
+    std::vector<Scenario> scenarios = createScenarios();
+    int failures = 0;
+
+    for ( const Scenario& scenario : scenarios )
+    {
+        if ( !only.empty() && scenario.name != only ) {
+            continue;
+        }
+        if ( list ) {
+            printf( "%s\n", scenario.name.c_str());
+            continue;
+        }
+
+        std::vector<std::vector<float>> output;
+        if ( !render( scenario, sampleRate, blockSize, output )) {
+            printf( "FAIL %-28s could not render\n", scenario.name.c_str());
+            ++failures;
+            continue;
+        }
+        std::string path = ( recordDir.empty() ? verifyDir : recordDir ) + "/" + scenario.name + ".wav";
+
+        if ( !recordDir.empty()) {
+            WaveWriter writer;
+            std::vector<float*> channels;
+            for ( auto& channel : output ) {
+                channels.push_back( channel.data());
+            }
+            if ( !writer.open( path.c_str(), ( int ) sampleRate, ( int ) channels.size(), 32 ) ||
+                 !writer.write( channels.data(), ( int ) output[ 0 ].size()) || !writer.close()) {
+                printf( "FAIL %-28s could not write %s\n", scenario.name.c_str(), path.c_str());
+                ++failures;
+                continue;
+            }
+            printf( "recorded %s\n", path.c_str());
+            continue;
+        }
+
+        WaveReader reader;
+        if ( !reader.load( path.c_str())) {
+            printf( "FAIL %-28s could not read reference %s\n", scenario.name.c_str(), path.c_str());
+            ++failures;
+            continue;
+        }
+        std::vector<std::vector<float>> reference;
+        for ( int c = 0; c < reader.getNumChannels(); ++c ) {
+            reference.push_back( reader.getChannel( c ));
+        }
+
+        std::string report;
+        bool pass = compare( reference, output, tolerance, report );
+        printf( "%s %-28s %s\n", pass ? "PASS" : "FAIL", scenario.name.c_str(), report.c_str());
+
+        if ( !pass ) {
+            ++failures;
+        }
+    }
+
+    if ( !verifyDir.empty()) {
+        printf( "%d scenario(s) failed\n", failures );
+    }
+    return failures > 0 ? 1 : 0;
+}
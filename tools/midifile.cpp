@@ -0,0 +1,283 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "midifile.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace Igorski {
+
+namespace {
+
+    // an event as read from a track, positioned in ticks, prior to the
+    // tempo map being applied (tempo changes are stored as meta events)
+
+    struct TrackEvent {
+        unsigned long tick;
+        size_t order; // keeps events on the same tick in file order
+        bool isTempo;
+        unsigned long microsecondsPerQuarter;
+        MidiEvent event;
+    };
+
+    const double DEFAULT_TEMPO = 120.0;
+
+    unsigned long readBigEndian( const unsigned char* data, int bytes )
+    {
+        unsigned long value = 0;
+        for ( int i = 0; i < bytes; ++i ) {
+            value = ( value << 8 ) | data[ i ];
+        }
+        return value;
+    }
+
+    // reads a variable length quantity, returns false when running out of bounds
+
+    bool readVariableLength( const std::vector<unsigned char>& data, size_t& offset, size_t end, unsigned long& value )
+    {
+        value = 0;
+        for ( int i = 0; i < 4; ++i ) {
+            if ( offset >= end ) {
+                return false;
+            }
+            unsigned char byte = data[ offset++ ];
+            value = ( value << 7 ) | ( byte & 0x7F );
+            if (( byte & 0x80 ) == 0 ) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+MidiFile::MidiFile()
+{
+
+}
+
+MidiFile::~MidiFile()
+{
+
+}
+
+bool MidiFile::load( const char* path )
+{
+    std::ifstream file( path, std::ios::binary );
+
+    if ( !file.good()) {
+        error = std::string( "could not open " ) + path;
+        return false;
+    }
+    std::vector<unsigned char> data(( std::istreambuf_iterator<char>( file )), std::istreambuf_iterator<char>());
+
+    return parse( data );
+}
+
+double MidiFile::getTempoAt( double seconds ) const
+{
+    double tempo = DEFAULT_TEMPO;
+
+    for ( const TempoEvent& tempoEvent : tempoEvents ) {
+        if ( tempoEvent.seconds > seconds ) {
+            break;
+        }
+        tempo = tempoEvent.tempo;
+    }
+    return tempo;
+}
+
+double MidiFile::getDuration() const
+{
+    return events.empty() ? 0.0 : events.back().seconds;
+}
+
+/* private methods */
+
+bool MidiFile::parse( const std::vector<unsigned char>& data )
+{
+    events.clear();
+    tempoEvents.clear();
+
+    if ( data.size() < 14 || std::string( data.begin(), data.begin() + 4 ) != "MThd" ) {
+        error = "not a Standard MIDI File";
+        return false;
+    }
+
+    unsigned long headerLength = readBigEndian( &data[ 4 ], 4 );
+    int format    = ( int ) readBigEndian( &data[ 8 ], 2 );
+    int numTracks = ( int ) readBigEndian( &data[ 10 ], 2 );
+    int division  = ( int ) readBigEndian( &data[ 12 ], 2 );
+
+    if ( format > 1 ) {
+        error = "only format 0 and 1 MIDI files are supported";
+        return false;
+    }
+
+    // a negative division describes SMPTE frames per second and ticks per frame
+    // in which case ticks map directly onto seconds (and tempo changes are meaningless)
+
+    bool isSMPTE           = ( division & 0x8000 ) != 0;
+    double ticksPerQuarter = division;
+    double ticksPerSecond  = 0.0;
+
+    if ( isSMPTE ) {
+        int framesPerSecond = -( static_cast<signed char>(( division >> 8 ) & 0xFF ));
+        ticksPerSecond = ( framesPerSecond == 29 ? 29.97 : framesPerSecond ) * ( division & 0xFF );
+    }
+
+    if (( !isSMPTE && ticksPerQuarter <= 0 ) || ( isSMPTE && ticksPerSecond <= 0 )) {
+        error = "invalid time division";
+        return false;
+    }
+
+    std::vector<TrackEvent> trackEvents;
+    size_t offset = 8 + headerLength;
+
+    for ( int track = 0; track < numTracks; ++track )
+    {
+        if ( offset + 8 > data.size()) {
+            break; // tolerate files declaring more tracks than they contain
+        }
+        unsigned long chunkLength = readBigEndian( &data[ offset + 4 ], 4 );
+        bool isTrack = std::string( data.begin() + offset, data.begin() + offset + 4 ) == "MTrk";
+
+        offset += 8;
+        size_t end = std::min( data.size(), ( size_t ) ( offset + chunkLength ));
+
+        if ( !isTrack ) {
+            offset = end; // skip unknown chunks
+            --track;
+            continue;
+        }
+
+        unsigned long tick  = 0;
+        unsigned char runningStatus = 0;
+
+        while ( offset < end )
+        {
+            unsigned long delta = 0;
+            if ( !readVariableLength( data, offset, end, delta ) || offset >= end ) {
+                break;
+            }
+            tick += delta;
+
+            unsigned char status = data[ offset ];
+
+            if ( status & 0x80 ) {
+                ++offset;
+            } else if ( runningStatus != 0 ) {
+                status = runningStatus; // running status, the data byte is read below
+            } else {
+                error = "malformed track data";
+                return false;
+            }
+
+            if ( status == 0xFF )
+            {
+                // meta event, we're only interested in tempo changes
+                if ( offset >= end ) {
+                    break;
+                }
+                unsigned char type = data[ offset++ ];
+                unsigned long length = 0;
+                if ( !readVariableLength( data, offset, end, length ) || offset + length > end ) {
+                    break;
+                }
+                if ( type == 0x51 && length == 3 && !isSMPTE ) {
+                    TrackEvent tempoEvent = {};
+                    tempoEvent.tick    = tick;
+                    tempoEvent.order   = trackEvents.size();
+                    tempoEvent.isTempo = true;
+                    tempoEvent.microsecondsPerQuarter = readBigEndian( &data[ offset ], 3 );
+                    trackEvents.push_back( tempoEvent );
+                }
+                offset += length;
+
+                if ( type == 0x2F ) {
+                    break; // end of track
+                }
+                continue;
+            }
+
+            if ( status == 0xF0 || status == 0xF7 )
+            {
+                // system exclusive, skip contents
+                unsigned long length = 0;
+                if ( !readVariableLength( data, offset, end, length )) {
+                    break;
+                }
+                offset += length;
+                continue;
+            }
+            runningStatus = status;
+
+            int dataBytes = (( status & 0xF0 ) == 0xC0 || ( status & 0xF0 ) == 0xD0 ) ? 1 : 2;
+            if ( offset + dataBytes > end ) {
+                break;
+            }
+
+            TrackEvent trackEvent = {};
+            trackEvent.tick          = tick;
+            trackEvent.order         = trackEvents.size();
+            trackEvent.isTempo       = false;
+            trackEvent.event.status  = status;
+            trackEvent.event.data1   = data[ offset ] & 0x7F;
+            trackEvent.event.data2   = dataBytes == 2 ? data[ offset + 1 ] & 0x7F : 0;
+            trackEvents.push_back( trackEvent );
+
+            offset += dataBytes;
+        }
+        offset = end;
+    }
+
+    // merge all tracks and apply the tempo map to translate ticks into seconds
+
+    std::stable_sort( trackEvents.begin(), trackEvents.end(), []( const TrackEvent& a, const TrackEvent& b ) {
+        return a.tick < b.tick;
+    });
+
+    double secondsPerTick = isSMPTE ? 1.0 / ticksPerSecond : ( 60.0 / DEFAULT_TEMPO ) / ticksPerQuarter;
+    double seconds        = 0.0;
+    unsigned long lastTick = 0;
+
+    for ( const TrackEvent& trackEvent : trackEvents )
+    {
+        seconds += ( trackEvent.tick - lastTick ) * secondsPerTick;
+        lastTick = trackEvent.tick;
+
+        if ( trackEvent.isTempo ) {
+            if ( trackEvent.microsecondsPerQuarter == 0 ) {
+                continue;
+            }
+            secondsPerTick = ( trackEvent.microsecondsPerQuarter / 1000000.0 ) / ticksPerQuarter;
+            tempoEvents.push_back({ seconds, 60000000.0 / trackEvent.microsecondsPerQuarter });
+            continue;
+        }
+        MidiEvent event = trackEvent.event;
+        event.seconds = seconds;
+        events.push_back( event );
+    }
+    return true;
+}
+
+} // E.O. namespace Igorski
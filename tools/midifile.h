@@ -0,0 +1,82 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MIDIFILE_HEADER__
+#define __MIDIFILE_HEADER__
+
+#include <string>
+#include <vector>
+
+namespace Igorski {
+
+    // data type for a single channel event read from a Standard MIDI File,
+    // positioned in absolute time (the files tempo map has already been applied)
+
+    struct MidiEvent {
+        double seconds;
+        unsigned char status;  // status byte, including the channel nibble
+        unsigned char data1;
+        unsigned char data2;
+    };
+
+    // data type for a tempo change within a Standard MIDI File
+
+    struct TempoEvent {
+        double seconds;
+        double tempo; // in BPM
+    };
+
+    /**
+     * Reads Standard MIDI Files (format 0 and 1) into a single list of
+     * channel events sorted by time, merging all tracks
+     */
+    class MidiFile {
+
+        public:
+            MidiFile();
+            ~MidiFile();
+
+            // parse the file at given path, returns false (and describes
+            // the reason in getError()) when the file could not be parsed
+            bool load( const char* path );
+
+            const std::vector<MidiEvent>&  getEvents() const { return events; }
+            const std::vector<TempoEvent>& getTempoEvents() const { return tempoEvents; }
+
+            // the tempo (in BPM) active at given time
+            double getTempoAt( double seconds ) const;
+
+            // time (in seconds) of the last event in the file
+            double getDuration() const;
+
+            const std::string& getError() const { return error; }
+
+        private:
+            std::vector<MidiEvent>  events;
+            std::vector<TempoEvent> tempoEvents;
+            std::string error;
+
+            bool parse( const std::vector<unsigned char>& data );
+    };
+}
+
+#endif
@@ -0,0 +1,194 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "offlinehost.h"
+#include "public.sdk/source/common/memorystream.h"
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace Igorski {
+
+OfflineHost::OfflineHost( double aSampleRate, int32 aMaxBlockSize, bool isDoublePrecision )
+: events( 4096 )
+, parameterChanges( 64 )
+, outputParameterChanges( 64 )
+, sampleRate( aSampleRate )
+, maxBlockSize( aMaxBlockSize )
+, lastBlockSize( 0 )
+, doublePrecision( isDoublePrecision )
+, silent( true )
+{
+    for ( int32 c = 0; c < NUM_CHANNELS; ++c ) {
+        floatBuffers [ c ] = new float [ maxBlockSize ]();
+        doubleBuffers[ c ] = new double[ maxBlockSize ]();
+    }
+
+    processor = new VSTSID();
+    processor->initialize( nullptr );
+
+    ProcessSetup setup;
+    setup.processMode        = kOffline;
+    setup.symbolicSampleSize = doublePrecision ? kSample64 : kSample32;
+    setup.maxSamplesPerBlock = maxBlockSize;
+    setup.sampleRate         = sampleRate;
+
+    processor->setupProcessing( setup );
+    processor->setActive( true );
+
+    processContext = {};
+    processContext.state      = ProcessContext::kPlaying | ProcessContext::kTempoValid;
+    processContext.sampleRate = sampleRate;
+    processContext.tempo      = 120.0;
+
+    outputBus = {};
+    outputBus.numChannels = NUM_CHANNELS;
+
+    if ( doublePrecision ) {
+        outputBus.channelBuffers64 = doubleBuffers;
+    } else {
+        outputBus.channelBuffers32 = floatBuffers;
+    }
+}
+
+OfflineHost::~OfflineHost()
+{
+    processor->setActive( false );
+    processor->terminate();
+    processor->release();
+
+    for ( int32 c = 0; c < NUM_CHANNELS; ++c ) {
+        delete[] floatBuffers [ c ];
+        delete[] doubleBuffers[ c ];
+    }
+}
+
+bool OfflineHost::loadState( const char* path )
+{
+    std::ifstream file( path, std::ios::binary );
+
+    if ( !file.good()) {
+        return false;
+    }
+    std::vector<char> data(( std::istreambuf_iterator<char>( file )), std::istreambuf_iterator<char>());
+
+    MemoryStream* stream = new MemoryStream( data.data(), ( TSize ) data.size());
+    bool success = processor->setState( stream ) == kResultOk;
+    stream->release();
+
+    return success;
+}
+
+void OfflineHost::setTempo( double tempo )
+{
+    processContext.tempo = tempo;
+}
+
+void OfflineHost::restart()
+{
+    processor->setActive( false );
+    processor->setActive( true );
+}
+
+void OfflineHost::noteOn( int32 sampleOffset, int16 pitch, float velocity, int16 channel )
+{
+    Event event = {};
+    event.type                = Event::kNoteOnEvent;
+    event.sampleOffset        = sampleOffset;
+    event.noteOn.channel      = channel;
+    event.noteOn.pitch        = pitch;
+    event.noteOn.velocity     = velocity;
+    event.noteOn.tuning       = 0.f;
+    event.noteOn.noteId       = -1;
+
+    events.addEvent( event );
+}
+
+void OfflineHost::noteOff( int32 sampleOffset, int16 pitch, int16 channel )
+{
+    Event event = {};
+    event.type                = Event::kNoteOffEvent;
+    event.sampleOffset        = sampleOffset;
+    event.noteOff.channel     = channel;
+    event.noteOff.pitch       = pitch;
+    event.noteOff.velocity    = 0.f;
+    event.noteOff.noteId      = -1;
+
+    events.addEvent( event );
+}
+
+void OfflineHost::setParameter( ParamID id, int32 sampleOffset, ParamValue value )
+{
+    int32 index = 0;
+    IParamValueQueue* queue = parameterChanges.addParameterData( id, index );
+
+    if ( queue != nullptr ) {
+        queue->addPoint( sampleOffset, value, index );
+    }
+}
+
+bool OfflineHost::process( int32 numSamples )
+{
+    if ( numSamples > maxBlockSize ) {
+        return false;
+    }
+
+    ProcessData data;
+    data.processMode            = kOffline;
+    data.symbolicSampleSize     = doublePrecision ? kSample64 : kSample32;
+    data.numSamples             = numSamples;
+    data.numInputs              = 0;
+    data.numOutputs             = 1;
+    data.outputs                = &outputBus;
+    data.inputEvents            = &events;
+    data.inputParameterChanges  = &parameterChanges;
+    data.outputParameterChanges = &outputParameterChanges;
+    data.processContext         = &processContext;
+
+    bool success = processor->process( data ) == kResultOk;
+
+    silent        = outputBus.silenceFlags != 0;
+    lastBlockSize = numSamples;
+
+    // advance the transport and flush the consumed events
+
+    processContext.projectTimeSamples += numSamples;
+    events.clear();
+    parameterChanges.clearQueue();
+    outputParameterChanges.clearQueue();
+
+    return success;
+}
+
+float** OfflineHost::getOutput()
+{
+    if ( doublePrecision ) {
+        for ( int32 c = 0; c < NUM_CHANNELS; ++c ) {
+            for ( int32 i = 0; i < lastBlockSize; ++i ) {
+                floatBuffers[ c ][ i ] = ( float ) doubleBuffers[ c ][ i ];
+            }
+        }
+    }
+    return floatBuffers;
+}
+
+} // E.O. namespace Igorski
@@ -0,0 +1,94 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __OFFLINEHOST_HEADER__
+#define __OFFLINEHOST_HEADER__
+
+#include "../src/vst.h"
+#include "public.sdk/source/vst/hosting/eventlist.h"
+#include "public.sdk/source/vst/hosting/parameterchanges.h"
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+
+namespace Igorski {
+
+    /**
+     * Minimal headless host that runs the VSTSID processor outside of a
+     * DAW (e.g. for offline rendering and benchmarking). Events and parameter
+     * changes are queued for the next process() call, which renders a single block
+     */
+    class OfflineHost {
+
+        public:
+            static const int32 NUM_CHANNELS = 2; // VSTSID exposes a single stereo output bus
+
+            OfflineHost( double sampleRate, int32 maxBlockSize, bool doublePrecision );
+            ~OfflineHost();
+
+            // restores the processor model from a file in the same layout as VSTSID::getState()
+            bool loadState( const char* path );
+
+            void setTempo( double tempo );
+
+            // deactivates and reactivates the processor (as hosts do when changing
+            // the processing setup), e.g. to apply VSTSID::setMaxWorkers()
+            void restart();
+
+            // queue events/parameter changes at given offset within the next processed block
+            void noteOn( int32 sampleOffset, int16 pitch, float velocity, int16 channel = 0 );
+            void noteOff( int32 sampleOffset, int16 pitch, int16 channel = 0 );
+            void setParameter( ParamID id, int32 sampleOffset, ParamValue value );
+
+            // renders given amount of samples (cannot exceed the max block size)
+            bool process( int32 numSamples );
+
+            // output of the last processed block (converted to single precision when
+            // processing in double precision)
+            float** getOutput();
+
+            bool isSilent() const { return silent; }
+
+            double getSampleRate() const { return sampleRate; }
+            int32 getMaxBlockSize() const { return maxBlockSize; }
+            VSTSID* getProcessor() { return processor; }
+
+        private:
+            VSTSID* processor;
+            EventList events;
+            ParameterChanges parameterChanges;
+            ParameterChanges outputParameterChanges; // e.g. the DSP load meter readings
+            ProcessContext processContext;
+            AudioBusBuffers outputBus;
+
+            double sampleRate;
+            int32 maxBlockSize;
+            int32 lastBlockSize;
+            bool doublePrecision;
+            bool silent;
+
+            float*  floatBuffers[ NUM_CHANNELS ];
+            double* doubleBuffers[ NUM_CHANNELS ];
+    };
+}
+
+#endif
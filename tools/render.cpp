@@ -0,0 +1,205 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "offlinehost.h"
+#include "midifile.h"
+#include "wavewriter.h"
+#include "../src/paramids.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace Igorski;
+
+/**
+ * vstsid_render: renders a Standard MIDI File through the VSTSID processor
+ * into a WAVE file, without requiring a VST host. Rendering happens as fast
+ * as possible, the achieved speed is reported as a multiple of realtime
+ */
+
+namespace {
+
+    struct Options {
+        std::string midiPath;
+        std::string outputPath;
+        std::string statePath;
+        double sampleRate  = 44100.0;
+        int32 blockSize    = 512;
+        int bitsPerSample  = 32;
+        double tail        = 2.0; // in seconds, rendered after the last MIDI event
+        bool doublePrecision = false;
+    };
+
+    void printUsage( const char* executable )
+    {
+        fprintf( stderr,
+            "Usage: %s --midi FILE --output FILE [options]\n\n"
+            "  --midi FILE         Standard MIDI File to render\n"
+            "  --output FILE       WAVE file to write\n"
+            "  --state FILE        processor state (as saved by VSTSID::getState) to render with\n"
+            "  --sample-rate RATE  sample rate in Hz (default 44100)\n"
+            "  --block-size SIZE   amount of samples rendered per process call (default 512)\n"
+            "  --bits BITS         16 (PCM) or 32 (float, default)\n"
+            "  --tail SECONDS      time to render after the last event (default 2)\n"
+            "  --double            process in double precision\n",
+            executable
+        );
+    }
+
+    bool parseOptions( int argc, char** argv, Options& options )
+    {
+        for ( int i = 1; i < argc; ++i )
+        {
+            std::string arg = argv[ i ];
+            bool hasValue   = i + 1 < argc;
+
+            if ( arg == "--double" ) {
+                options.doublePrecision = true;
+            } else if ( arg == "--midi" && hasValue ) {
+                options.midiPath = argv[ ++i ];
+            } else if ( arg == "--output" && hasValue ) {
+                options.outputPath = argv[ ++i ];
+            } else if ( arg == "--state" && hasValue ) {
+                options.statePath = argv[ ++i ];
+            } else if ( arg == "--sample-rate" && hasValue ) {
+                options.sampleRate = atof( argv[ ++i ]);
+            } else if ( arg == "--block-size" && hasValue ) {
+                options.blockSize = atoi( argv[ ++i ]);
+            } else if ( arg == "--bits" && hasValue ) {
+                options.bitsPerSample = atoi( argv[ ++i ]);
+            } else if ( arg == "--tail" && hasValue ) {
+                options.tail = atof( argv[ ++i ]);
+            } else {
+                fprintf( stderr, "Unknown or incomplete argument: %s\n\n", arg.c_str());
+                return false;
+            }
+        }
+        return !options.midiPath.empty() && !options.outputPath.empty() &&
+               options.sampleRate > 0 && options.blockSize > 0 && options.tail >= 0 &&
+               ( options.bitsPerSample == 16 || options.bitsPerSample == 32 );
+    }
+
+    // queues given MIDI event into the hosts next block
+
+    void queueEvent( OfflineHost& host, const MidiEvent& event, int32 sampleOffset )
+    {
+        int16 channel = event.status & 0x0F;
+
+        switch ( event.status & 0xF0 )
+        {
+            case 0x90:
+                if ( event.data2 > 0 ) {
+                    host.noteOn( sampleOffset, event.data1, event.data2 / 127.f, channel );
+                    break;
+                }
+                // noteOn with zero velocity is a noteOff
+                host.noteOff( sampleOffset, event.data1, channel );
+                break;
+
+            case 0x80:
+                host.noteOff( sampleOffset, event.data1, channel );
+                break;
+
+            case 0xE0:
+                // pitch bend is mapped onto the master tuning parameter (also see VSTSIDController MIDI CC mapping)
+                host.setParameter( kMasterTuningId, sampleOffset, (( event.data2 << 7 ) | event.data1 ) / 16383.0 );
+                break;
+        }
+    }
+}
+
+int main( int argc, char** argv )
+{
+    Options options;
+
+    if ( !parseOptions( argc, argv, options )) {
+        printUsage( argv[ 0 ]);
+        return 1;
+    }
+
+    MidiFile midiFile;
+    if ( !midiFile.load( options.midiPath.c_str())) {
+        fprintf( stderr, "Could not read MIDI file: %s\n", midiFile.getError().c_str());
+        return 1;
+    }
+
+    OfflineHost host( options.sampleRate, options.blockSize, options.doublePrecision );
+
+    if ( !options.statePath.empty() && !host.loadState( options.statePath.c_str())) {
+        fprintf( stderr, "Could not restore processor state from %s\n", options.statePath.c_str());
+        return 1;
+    }
+
+    WaveWriter writer;
+    if ( !writer.open( options.outputPath.c_str(), ( int ) options.sampleRate, OfflineHost::NUM_CHANNELS, options.bitsPerSample )) {
+        fprintf( stderr, "Could not open %s for writing\n", options.outputPath.c_str());
+        return 1;
+    }
+
+    const std::vector<MidiEvent>& events = midiFile.getEvents();
+    int64 totalSamples = ( int64 ) ceil(( midiFile.getDuration() + options.tail ) * options.sampleRate );
+    size_t eventIndex  = 0;
+
+    double processTime = 0.0;
+    auto renderStart   = std::chrono::steady_clock::now();
+
+    for ( int64 blockStart = 0; blockStart < totalSamples; blockStart += options.blockSize )
+    {
+        int32 numSamples = ( int32 ) std::min(( int64 ) options.blockSize, totalSamples - blockStart );
+        int64 blockEnd   = blockStart + numSamples;
+
+        while ( eventIndex < events.size())
+        {
+            int64 eventSample = ( int64 ) ( events[ eventIndex ].seconds * options.sampleRate );
+            if ( eventSample >= blockEnd ) {
+                break;
+            }
+            queueEvent( host, events[ eventIndex ], ( int32 ) std::max(( int64 ) 0, eventSample - blockStart ));
+            ++eventIndex;
+        }
+        host.setTempo( midiFile.getTempoAt( blockStart / options.sampleRate ));
+
+        auto processStart = std::chrono::steady_clock::now();
+        host.process( numSamples );
+        processTime += std::chrono::duration<double>( std::chrono::steady_clock::now() - processStart ).count();
+
+        if ( !writer.write( host.getOutput(), numSamples )) {
+            fprintf( stderr, "Could not write to %s\n", options.outputPath.c_str());
+            return 1;
+        }
+    }
+    writer.close();
+
+    double totalTime    = std::chrono::duration<double>( std::chrono::steady_clock::now() - renderStart ).count();
+    double renderedTime = totalSamples / options.sampleRate;
+
+    printf( "Rendered %.2f seconds of audio (%zu events) to %s\n", renderedTime, events.size(), options.outputPath.c_str());
+    printf( "Processing: %.3f s (%.1fx realtime)\n", processTime, processTime > 0.0 ? renderedTime / processTime : 0.0 );
+    printf( "Total:      %.3f s (%.1fx realtime)\n", totalTime,   totalTime   > 0.0 ? renderedTime / totalTime   : 0.0 );
+
+    return 0;
+}
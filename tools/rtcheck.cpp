@@ -0,0 +1,335 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "offlinehost.h"
+#include "rtsafety.h"
+#include "../src/paramids.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Igorski;
+
+/**
+ * vstsid_rtcheck: runs scripted MIDI and automation storms through VSTSID::process()
+ * while trapping all memory allocations, locks and system calls made from within
+ * the process() call. By default the first violation prints a stack trace and
+ * fails the run (pipe the output through c++filt to demangle the symbol names)
+ * Runs also fail when process() does not restore the floating point mode of the
+ * calling thread (the processor flushes subnormal values while processing)
+ */
+
+namespace {
+
+    const int LOWEST_PITCH  = 24;
+    const int HIGHEST_PITCH = 96;
+
+    // tracks the held notes (and the MIDI channel they were played on) so storms can release them
+
+    struct Keyboard {
+        bool held[ 128 ] = {};
+        int16 channels[ 128 ] = {};
+        int16 channel = 0; // channel on which subsequent notes are played
+
+        void on( OfflineHost& host, int32 offset, int pitch, float velocity ) {
+            host.noteOn( offset, ( int16 ) pitch, velocity, channel );
+            held[ pitch ]     = true;
+            channels[ pitch ] = channel;
+        }
+
+        void off( OfflineHost& host, int32 offset, int pitch ) {
+            host.noteOff( offset, ( int16 ) pitch, channels[ pitch ]);
+            held[ pitch ] = false;
+        }
+
+        void releaseAll( OfflineHost& host, int32 offset ) {
+            for ( int pitch = 0; pitch < 128; ++pitch ) {
+                if ( held[ pitch ]) {
+                    off( host, offset, pitch );
+                }
+            }
+        }
+    };
+
+    typedef void ( *Schedule )( OfflineHost& host, Keyboard& keyboard, int block, int32 blockSize, std::mt19937& random );
+
+    struct Storm {
+        const char* name;
+        Schedule schedule;
+        bool multiTimbral = false; // whether the parts are rendered by the worker pool
+    };
+
+    // up to 16 random note on/off events per block
+
+    void noteStorm( OfflineHost& host, Keyboard& keyboard, int /*block*/, int32 blockSize, std::mt19937& random )
+    {
+        std::uniform_int_distribution<int> amount( 1, 16 );
+        std::uniform_int_distribution<int> pitch( LOWEST_PITCH, HIGHEST_PITCH );
+        std::uniform_int_distribution<int32> offset( 0, blockSize - 1 );
+        std::uniform_real_distribution<float> velocity( 0.1f, 1.f );
+
+        for ( int i = amount( random ); i > 0; --i ) {
+            int note = pitch( random );
+            if ( keyboard.held[ note ]) {
+                keyboard.off( host, offset( random ), note );
+            } else {
+                keyboard.on( host, offset( random ), note, velocity( random ));
+            }
+        }
+    }
+
+    // six note chords that repeatedly cross the arpeggiator threshold
+
+    void chordStabs( OfflineHost& host, Keyboard& keyboard, int block, int32 blockSize, std::mt19937& random )
+    {
+        std::uniform_int_distribution<int> root( LOWEST_PITCH, HIGHEST_PITCH - 12 );
+
+        switch ( block % 4 ) {
+            case 0: {
+                int note = root( random );
+                for ( int interval : { 0, 3, 7, 10, 12, 14 }) {
+                    keyboard.on( host, 0, note + interval, 0.8f );
+                }
+                break;
+            }
+            case 2:
+                // release all but two, dropping below the threshold
+                for ( int pitch = 0, kept = 0; pitch < 128; ++pitch ) {
+                    if ( keyboard.held[ pitch ] && ++kept > 2 ) {
+                        keyboard.off( host, blockSize / 2, pitch );
+                    }
+                }
+                break;
+            case 3:
+                keyboard.releaseAll( host, blockSize - 1 );
+                break;
+        }
+    }
+
+    // overlapping legato notes that glide and restore pitch on release
+
+    void legatoGlide( OfflineHost& host, Keyboard& keyboard, int block, int32 blockSize, std::mt19937& random )
+    {
+        std::uniform_int_distribution<int> pitch( LOWEST_PITCH, HIGHEST_PITCH );
+
+        if ( block == 0 ) {
+            host.setParameter( kPortamentoId, 0, 0.3 );
+        }
+        if ( block % 8 == 7 ) {
+            keyboard.releaseAll( host, 0 );
+            return;
+        }
+        keyboard.on( host, blockSize / 2, pitch( random ), 0.7f );
+    }
+
+    // the same pitch triggered repeatedly without being released
+
+    void retrigger( OfflineHost& host, Keyboard& /*keyboard*/, int block, int32 blockSize, std::mt19937& /*random*/ )
+    {
+        host.noteOn( 0, 60, 0.8f );
+        host.noteOn( blockSize / 2, 60, 0.6f );
+
+        if ( block % 16 == 15 ) {
+            host.noteOff( blockSize - 1, 60 );
+        }
+    }
+
+    // every parameter changes multiple times per block while notes are playing
+
+    void parameterStorm( OfflineHost& host, Keyboard& keyboard, int block, int32 blockSize, std::mt19937& random )
+    {
+        std::uniform_real_distribution<double> value( 0.0, 1.0 );
+
+        for ( ParamID id : { kAttackId, kDecayId, kSustainId, kReleaseId, kCutoffId, kResonanceId, kLFORateId,
+                             kLFODepthId, kRingModRateId, kPortamentoId, kMasterTuningId, kBandLimitedId, kFilterModeId,
+                             kVoiceFilterId, kFilterEnvelopeId }) {
+            for ( int32 offset = 0; offset < blockSize; offset += std::max( 1, blockSize / 4 )) {
+                host.setParameter( id, offset, value( random ));
+            }
+        }
+        noteStorm( host, keyboard, block, blockSize, random );
+    }
+
+    // note storms spread over all MIDI channels, with each part using its own filter settings
+
+    void multiTimbralStorm( OfflineHost& host, Keyboard& keyboard, int block, int32 blockSize, std::mt19937& random )
+    {
+        std::uniform_int_distribution<int> channel( 0, VST::MAX_PARTS - 1 );
+        std::uniform_real_distribution<double> value( 0.0, 1.0 );
+
+        ParamID id = VST::getPartParameterId( kCutoffId, channel( random ));
+        host.setParameter( id, blockSize / 2, value( random ));
+
+        keyboard.channel = ( int16 ) channel( random );
+        noteStorm( host, keyboard, block, blockSize, random );
+    }
+
+    const Storm STORMS[] = {
+        { "note-storm",      noteStorm },
+        { "chord-stabs",     chordStabs },
+        { "legato-glide",    legatoGlide },
+        { "retrigger",       retrigger },
+        { "parameter-storm", parameterStorm },
+        { "multi-timbral",   multiTimbralStorm, true },
+    };
+
+    // whether the floating point mode of the calling thread retains subnormal values (e.g. flush-to-zero is off)
+
+    bool retainsSubnormals()
+    {
+        volatile float smallest = std::numeric_limits<float>::min();
+        return smallest * .5f != 0.f;
+    }
+
+    int alteredModes = 0; // amount of process() calls that did not restore the floating point mode
+
+    bool run( const Storm& storm, int32 blockSize, bool doublePrecision, int blocks, unsigned int seed )
+    {
+        OfflineHost host( 44100.0, blockSize, doublePrecision );
+        Keyboard keyboard;
+        std::mt19937 random( seed );
+
+        // long release times to accumulate voices
+        host.setParameter( kReleaseId, 0, 0.5 );
+
+        // the workers are started when the processor is activated (outside of the audio thread),
+        // in multi-timbral mode these render the parts
+
+        if ( storm.multiTimbral ) {
+            host.setParameter( kMultiTimbralId, 0, 1.0 );
+            for ( int part = 1; part < VST::MAX_PARTS; ++part ) {
+                host.setParameter( VST::getPartParameterId( kReleaseId, part ), 0, 0.5 );
+            }
+            if ( !host.process( blockSize )) {
+                return false;
+            }
+        }
+
+        for ( int block = 0; block < blocks; ++block )
+        {
+            storm.schedule( host, keyboard, block, blockSize, random );
+
+            RTSafety::AudioThreadScope audioThread;
+
+            if ( !host.process( blockSize )) {
+                return false;
+            }
+            if ( !retainsSubnormals()) {
+                ++alteredModes;
+            }
+        }
+        return true;
+    }
+
+    void printUsage( const char* executable )
+    {
+        fprintf( stderr,
+            "Usage: %s [options]\n\n"
+            "  --storm NAME        only run the storm with given name\n"
+            "  --block-size SIZE   amount of samples per process call (default runs 64 and 512)\n"
+            "  --blocks AMOUNT     amount of blocks to process per run (default 2000)\n"
+            "  --seed SEED         random seed for the storms (default 1)\n"
+            "  --keep-going        count all violations instead of failing on the first one\n",
+            executable
+        );
+    }
+}
+
+int main( int argc, char** argv )
+{
+    std::string only;
+    std::vector<int32> blockSizes = { 64, 512 };
+    int blocks        = 2000;
+    unsigned int seed = 1;
+    bool keepGoing    = false;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        std::string arg = argv[ i ];
+        bool hasValue   = i + 1 < argc;
+
+        if ( arg == "--storm" && hasValue ) {
+            only = argv[ ++i ];
+        } else if ( arg == "--block-size" && hasValue ) {
+            blockSizes = { atoi( argv[ ++i ]) };
+        } else if ( arg == "--blocks" && hasValue ) {
+            blocks = atoi( argv[ ++i ]);
+        } else if ( arg == "--seed" && hasValue ) {
+            seed = ( unsigned int ) atoi( argv[ ++i ]);
+        } else if ( arg == "--keep-going" ) {
+            keepGoing = true;
+        } else {
+            fprintf( stderr, "Unknown or incomplete argument: %s\n\n", arg.c_str());
+            printUsage( argv[ 0 ]);
+            return 1;
+        }
+    }
+
+    if ( blockSizes[ 0 ] <= 0 || blocks <= 0 ) {
+        printUsage( argv[ 0 ]);
+        return 1;
+    }
+
+    RTSafety::init( !keepGoing );
+    int failures = 0;
+
+    for ( const Storm& storm : STORMS )
+    {
+        if ( !only.empty() && only != storm.name ) {
+            continue;
+        }
+        for ( int32 blockSize : blockSizes ) {
+            for ( bool doublePrecision : { false, true }) {
+                printf( "%s/buffer:%d/%s ", storm.name, blockSize, doublePrecision ? "double" : "float" );
+                fflush( stdout ); // violations exit without flushing
+
+                RTSafety::reset();
+                alteredModes   = 0;
+                bool processed = run( storm, blockSize, doublePrecision, blocks, seed );
+
+                if ( !processed ) {
+                    printf( "FAIL (process() returned an error)\n" );
+                    ++failures;
+                } else if ( RTSafety::getTotalViolations() > 0 ) {
+                    printf( "FAIL (" );
+                    for ( int type = 0; type < RTSafety::VIOLATION_AMOUNT; ++type ) {
+                        printf( "%s%d %s", type > 0 ? ", " : "", RTSafety::getViolations(( RTSafety::Violation ) type ),
+                                RTSafety::getName(( RTSafety::Violation ) type ));
+                    }
+                    printf( ")\n" );
+                    ++failures;
+                } else if ( alteredModes > 0 ) {
+                    printf( "FAIL (%d blocks altered the floating point mode)\n", alteredModes );
+                    ++failures;
+                } else {
+                    printf( "PASS\n" );
+                }
+            }
+        }
+    }
+    return failures > 0 ? 1 : 0;
+}
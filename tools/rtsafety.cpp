@@ -0,0 +1,445 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+// the fortified stdio wrappers would collide with the interposed definitions below
+#undef _FORTIFY_SOURCE
+
+#include "rtsafety.h"
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <unistd.h>
+
+#if defined( __GLIBC__ )
+#define RTSAFETY_INTERPOSE
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <time.h>
+
+extern "C" {
+    void* __libc_malloc( size_t size );
+    void* __libc_calloc( size_t amount, size_t size );
+    void* __libc_realloc( void* pointer, size_t size );
+    void* __libc_memalign( size_t alignment, size_t size );
+    void  __libc_free( void* pointer );
+}
+#endif
+
+namespace Igorski {
+namespace RTSafety {
+
+namespace {
+
+    const int MAX_STACK_DEPTH = 64;
+
+    thread_local int  audioThreadDepth = 0;
+    thread_local bool reporting        = false;
+
+    std::atomic<int> violations[ VIOLATION_AMOUNT ];
+    bool exitOnViolation = true;
+
+#ifdef RTSAFETY_INTERPOSE
+
+    // the C library implementations of the interposed functions
+
+    struct {
+        ssize_t ( *write )( int, const void*, size_t );
+        ssize_t ( *read )( int, void*, size_t );
+        size_t  ( *fwrite )( const void*, size_t, size_t, FILE* );
+        int     ( *fputs )( const char*, FILE* );
+        int     ( *fputc )( int, FILE* );
+        int     ( *puts )( const char* );
+        int     ( *vfprintf )( FILE*, const char*, va_list );
+        int     ( *usleep )( useconds_t );
+        int     ( *nanosleep )( const struct timespec*, struct timespec* );
+        int     ( *posix_memalign )( void**, size_t, size_t );
+        int     ( *pthread_mutex_lock )( pthread_mutex_t* );
+        int     ( *pthread_rwlock_rdlock )( pthread_rwlock_t* );
+        int     ( *pthread_rwlock_wrlock )( pthread_rwlock_t* );
+        int     ( *pthread_cond_wait )( pthread_cond_t*, pthread_mutex_t* );
+    } real = {};
+
+    template <typename Function>
+    void resolve( Function& function, const char* name )
+    {
+        function = reinterpret_cast<Function>( dlsym( RTLD_NEXT, name ));
+    }
+
+    // dlsym() can allocate, as such all symbols are resolved once before entering the audio thread
+
+    void resolveAll()
+    {
+        if ( real.write != nullptr ) {
+            return;
+        }
+        resolve( real.read,                  "read" );
+        resolve( real.fwrite,                "fwrite" );
+        resolve( real.fputs,                 "fputs" );
+        resolve( real.fputc,                 "fputc" );
+        resolve( real.puts,                  "puts" );
+        resolve( real.vfprintf,              "vfprintf" );
+        resolve( real.usleep,                "usleep" );
+        resolve( real.nanosleep,             "nanosleep" );
+        resolve( real.posix_memalign,        "posix_memalign" );
+        resolve( real.pthread_mutex_lock,    "pthread_mutex_lock" );
+        resolve( real.pthread_rwlock_rdlock, "pthread_rwlock_rdlock" );
+        resolve( real.pthread_rwlock_wrlock, "pthread_rwlock_wrlock" );
+        resolve( real.pthread_cond_wait,     "pthread_cond_wait" );
+        resolve( real.write,                 "write" );
+    }
+
+    void* allocate( size_t size, size_t alignment = 0 )
+    {
+        return alignment > sizeof( void* ) ? __libc_memalign( alignment, size ) : __libc_malloc( size );
+    }
+
+    void deallocate( void* pointer )
+    {
+        __libc_free( pointer );
+    }
+
+#else
+
+    void resolveAll() {}
+
+    void* allocate( size_t size, size_t alignment = 0 )
+    {
+        if ( alignment <= sizeof( void* )) {
+            return malloc( size );
+        }
+        return aligned_alloc( alignment, (( size + alignment - 1 ) / alignment ) * alignment );
+    }
+
+    void deallocate( void* pointer )
+    {
+        free( pointer );
+    }
+
+#endif
+
+    void printStackTrace()
+    {
+#ifdef RTSAFETY_INTERPOSE
+        void* frames[ MAX_STACK_DEPTH ];
+        int depth = backtrace( frames, MAX_STACK_DEPTH );
+
+        // skip the frames of the trap itself
+        backtrace_symbols_fd( frames + 2, depth - 2, STDERR_FILENO );
+#endif
+    }
+
+    void report( Violation type, const char* function )
+    {
+        if ( audioThreadDepth == 0 || reporting ) {
+            return;
+        }
+        reporting = true;
+
+        int count = ++violations[ type ];
+
+        // when not exiting, only the first violation of each type is traced to keep the output readable
+
+        if ( exitOnViolation || count == 1 ) {
+            fprintf( stderr, "\n[rtcheck] %s on the audio thread: %s()\n", getName( type ), function );
+            printStackTrace();
+            fflush( stderr );
+        }
+
+        if ( exitOnViolation ) {
+            _exit( 1 );
+        }
+        reporting = false;
+    }
+}
+
+void init( bool failFast )
+{
+    exitOnViolation = failFast;
+    resolveAll();
+
+#ifdef RTSAFETY_INTERPOSE
+    // backtrace() loads its unwinder (allocating) on first use
+    void* frames[ 1 ];
+    backtrace( frames, 1 );
+#endif
+    reset();
+}
+
+void enterAudioThread()
+{
+    ++audioThreadDepth;
+}
+
+void leaveAudioThread()
+{
+    --audioThreadDepth;
+}
+
+int getViolations( Violation type )
+{
+    return violations[ type ];
+}
+
+int getTotalViolations()
+{
+    int total = 0;
+    for ( int i = 0; i < VIOLATION_AMOUNT; ++i ) {
+        total += violations[ i ];
+    }
+    return total;
+}
+
+void reset()
+{
+    for ( int i = 0; i < VIOLATION_AMOUNT; ++i ) {
+        violations[ i ] = 0;
+    }
+}
+
+const char* getName( Violation type )
+{
+    switch ( type ) {
+        default:
+        case ALLOCATION:
+            return "memory allocation";
+        case DEALLOCATION:
+            return "memory deallocation";
+        case LOCK:
+            return "lock";
+        case SYSCALL:
+            return "system call";
+    }
+}
+
+} // E.O. namespace RTSafety
+} // E.O. namespace Igorski
+
+using namespace Igorski::RTSafety;
+
+/* global operator new/delete */
+
+namespace {
+
+    void* trapNew( size_t size, size_t alignment, const char* function )
+    {
+        report( ALLOCATION, function );
+        return allocate( size > 0 ? size : 1, alignment );
+    }
+
+    void trapDelete( void* pointer, const char* function )
+    {
+        if ( pointer != nullptr ) {
+            report( DEALLOCATION, function );
+            deallocate( pointer );
+        }
+    }
+
+    void* throwingNew( size_t size, size_t alignment, const char* function )
+    {
+        void* pointer = trapNew( size, alignment, function );
+        if ( pointer == nullptr ) {
+            throw std::bad_alloc();
+        }
+        return pointer;
+    }
+}
+
+void* operator new( size_t size ) { return throwingNew( size, 0, "operator new" ); }
+void* operator new[]( size_t size ) { return throwingNew( size, 0, "operator new[]" ); }
+void* operator new( size_t size, const std::nothrow_t& ) noexcept { return trapNew( size, 0, "operator new" ); }
+void* operator new[]( size_t size, const std::nothrow_t& ) noexcept { return trapNew( size, 0, "operator new[]" ); }
+void* operator new( size_t size, std::align_val_t alignment ) { return throwingNew( size, ( size_t ) alignment, "operator new" ); }
+void* operator new[]( size_t size, std::align_val_t alignment ) { return throwingNew( size, ( size_t ) alignment, "operator new[]" ); }
+
+void operator delete( void* pointer ) noexcept { trapDelete( pointer, "operator delete" ); }
+void operator delete[]( void* pointer ) noexcept { trapDelete( pointer, "operator delete[]" ); }
+void operator delete( void* pointer, size_t ) noexcept { trapDelete( pointer, "operator delete" ); }
+void operator delete[]( void* pointer, size_t ) noexcept { trapDelete( pointer, "operator delete[]" ); }
+void operator delete( void* pointer, std::align_val_t ) noexcept { trapDelete( pointer, "operator delete" ); }
+void operator delete[]( void* pointer, std::align_val_t ) noexcept { trapDelete( pointer, "operator delete[]" ); }
+void operator delete( void* pointer, size_t, std::align_val_t ) noexcept { trapDelete( pointer, "operator delete" ); }
+void operator delete[]( void* pointer, size_t, std::align_val_t ) noexcept { trapDelete( pointer, "operator delete[]" ); }
+
+/* C library interposers */
+
+#ifdef RTSAFETY_INTERPOSE
+
+extern "C" {
+
+void* malloc( size_t size )
+{
+    report( ALLOCATION, "malloc" );
+    return __libc_malloc( size );
+}
+
+void* calloc( size_t amount, size_t size )
+{
+    report( ALLOCATION, "calloc" );
+    return __libc_calloc( amount, size );
+}
+
+void* realloc( void* pointer, size_t size )
+{
+    report( ALLOCATION, "realloc" );
+    return __libc_realloc( pointer, size );
+}
+
+void free( void* pointer )
+{
+    if ( pointer != nullptr ) {
+        report( DEALLOCATION, "free" );
+    }
+    __libc_free( pointer );
+}
+
+int posix_memalign( void** pointer, size_t alignment, size_t size )
+{
+    report( ALLOCATION, "posix_memalign" );
+    resolveAll();
+    return real.posix_memalign( pointer, alignment, size );
+}
+
+int pthread_mutex_lock( pthread_mutex_t* mutex )
+{
+    report( LOCK, "pthread_mutex_lock" );
+    resolveAll();
+    return real.pthread_mutex_lock( mutex );
+}
+
+int pthread_rwlock_rdlock( pthread_rwlock_t* lock )
+{
+    report( LOCK, "pthread_rwlock_rdlock" );
+    resolveAll();
+    return real.pthread_rwlock_rdlock( lock );
+}
+
+int pthread_rwlock_wrlock( pthread_rwlock_t* lock )
+{
+    report( LOCK, "pthread_rwlock_wrlock" );
+    resolveAll();
+    return real.pthread_rwlock_wrlock( lock );
+}
+
+int pthread_cond_wait( pthread_cond_t* condition, pthread_mutex_t* mutex )
+{
+    report( LOCK, "pthread_cond_wait" );
+    resolveAll();
+    return real.pthread_cond_wait( condition, mutex );
+}
+
+ssize_t write( int fd, const void* buffer, size_t size )
+{
+    report( SYSCALL, "write" );
+    resolveAll();
+    return real.write( fd, buffer, size );
+}
+
+ssize_t read( int fd, void* buffer, size_t size )
+{
+    report( SYSCALL, "read" );
+    resolveAll();
+    return real.read( fd, buffer, size );
+}
+
+int usleep( useconds_t duration )
+{
+    report( SYSCALL, "usleep" );
+    resolveAll();
+    return real.usleep( duration );
+}
+
+int nanosleep( const struct timespec* duration, struct timespec* remaining )
+{
+    report( SYSCALL, "nanosleep" );
+    resolveAll();
+    return real.nanosleep( duration, remaining );
+}
+
+// stdio calls the write syscall internally (bypassing the interposer above)
+
+size_t fwrite( const void* data, size_t size, size_t amount, FILE* stream )
+{
+    report( SYSCALL, "fwrite" );
+    resolveAll();
+    return real.fwrite( data, size, amount, stream );
+}
+
+int fputs( const char* text, FILE* stream )
+{
+    report( SYSCALL, "fputs" );
+    resolveAll();
+    return real.fputs( text, stream );
+}
+
+int fputc( int character, FILE* stream )
+{
+    report( SYSCALL, "fputc" );
+    resolveAll();
+    return real.fputc( character, stream );
+}
+
+int puts( const char* text )
+{
+    report( SYSCALL, "puts" );
+    resolveAll();
+    return real.puts( text );
+}
+
+int vfprintf( FILE* stream, const char* format, va_list arguments )
+{
+    report( SYSCALL, "vfprintf" );
+    resolveAll();
+    return real.vfprintf( stream, format, arguments );
+}
+
+int fprintf( FILE* stream, const char* format, ... )
+{
+    report( SYSCALL, "fprintf" );
+    resolveAll();
+
+    va_list arguments;
+    va_start( arguments, format );
+    int result = real.vfprintf( stream, format, arguments );
+    va_end( arguments );
+
+    return result;
+}
+
+int printf( const char* format, ... )
+{
+    report( SYSCALL, "printf" );
+    resolveAll();
+
+    va_list arguments;
+    va_start( arguments, format );
+    int result = real.vfprintf( stdout, format, arguments );
+    va_end( arguments );
+
+    return result;
+}
+
+} // extern "C"
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __RTSAFETY_HEADER__
+#define __RTSAFETY_HEADER__
+
+namespace Igorski {
+
+    /**
+     * Traps operations that are not real-time safe (memory allocation, locking mutexes
+     * and system calls / stdio) while the calling thread is flagged as the audio thread.
+     * The traps are implemented by overriding the global operator new/delete and by
+     * interposing the C library functions (glibc only), which requires rtsafety.cpp to
+     * be linked into the executable under test.
+     */
+    namespace RTSafety {
+
+        enum Violation {
+            ALLOCATION = 0,
+            DEALLOCATION,
+            LOCK,
+            SYSCALL,
+            VIOLATION_AMOUNT
+        };
+
+        // prepares the stack trace facilities (these allocate on first use), when
+        // fail fast is true, the process exits on the first violation
+        void init( bool failFast );
+
+        // flags the current thread as the audio thread (nestable)
+        void enterAudioThread();
+        void leaveAudioThread();
+
+        int getViolations( Violation type );
+        int getTotalViolations();
+        void reset();
+
+        const char* getName( Violation type );
+
+        // flags the current thread as the audio thread for the lifetime of this scope
+
+        class AudioThreadScope {
+            public:
+                AudioThreadScope()  { enterAudioThread(); }
+                ~AudioThreadScope() { leaveAudioThread(); }
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,302 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "offlinehost.h"
+#include "../src/paramids.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Igorski;
+
+/**
+ * vstsid_stress: measures the worst case block processing time of the full
+ * VSTSID::process() path under MIDI storms (hundreds of note events per block
+ * with repeated pitches and glide enabled, repeatedly crossing the arpeggiator
+ * threshold). Rather than the average, the distribution of the block times is
+ * reported relative to the real-time deadline (the duration of a block)
+ */
+
+namespace {
+
+    const double SAMPLE_RATE  = 44100.0;
+    const int BUFFER_SIZES[]  = { 32, 64, 128, 256, 512, 1024 };
+    const int WARMUP_BLOCKS   = 16;
+    const int LOWEST_PITCH    = 36;
+    const int PITCH_RANGE     = 24; // a narrow range ensures pitches are repeated
+
+    // upper bounds of the histogram buckets, in percent of the deadline
+    const double BUCKETS[]    = { 1, 2, 5, 10, 25, 50, 100 };
+    const int BUCKET_AMOUNT   = sizeof( BUCKETS ) / sizeof( double ) + 1;
+
+    struct Options {
+        std::string outputPath;
+        int bufferSize      = 0; // 0 runs all BUFFER_SIZES
+        int eventsPerBlock  = 200;
+        double seconds      = 10.0;
+        bool doublePrecision = false;
+        unsigned int seed   = 1;
+    };
+
+    struct Result {
+        int bufferSize;
+        int blocks;
+        double deadline; // in microseconds
+        double p50;
+        double p99;
+        double p999;
+        double max;
+        int misses;      // blocks that exceeded the deadline
+        int histogram[ BUCKET_AMOUNT ];
+    };
+
+    // the block pattern cycles through dense bursts, dropping below the arpeggiator
+    // threshold and releasing all notes. Every other cycle has glide enabled, during
+    // which note on events are taken over by the first held note (growing its pitch
+    // history) rather than creating new voices
+
+    void schedule( OfflineHost& host, bool* held, int block, int32 bufferSize, int eventsPerBlock, std::mt19937& random )
+    {
+        std::uniform_int_distribution<int> pitch( LOWEST_PITCH, LOWEST_PITCH + PITCH_RANGE - 1 );
+        std::uniform_int_distribution<int32> offset( 0, bufferSize - 1 );
+        std::uniform_real_distribution<float> chance( 0.f, 1.f );
+
+        if ( block % 8 == 0 ) {
+            host.setParameter( kPortamentoId, 0, ( block / 8 ) % 2 ? 0.5 : 0.0 );
+        }
+
+        switch ( block % 8 ) {
+            default:
+                for ( int i = 0; i < eventsPerBlock; ++i ) {
+                    int note = pitch( random );
+                    // favour note on events to build up voices, note on events for held
+                    // pitches are deliberately sent again (retriggering)
+                    if ( held[ note ] && chance( random ) < 0.4f ) {
+                        host.noteOff( offset( random ), ( int16 ) note );
+                        held[ note ] = false;
+                    } else {
+                        host.noteOn( offset( random ), ( int16 ) note, 0.2f + 0.8f * chance( random ));
+                        held[ note ] = true;
+                    }
+                }
+                break;
+            case 6:
+                // release all but two notes, dropping below the arpeggiator threshold
+                for ( int note = 0, kept = 0; note < 128; ++note ) {
+                    if ( held[ note ] && ++kept > 2 ) {
+                        host.noteOff( 0, ( int16 ) note );
+                        held[ note ] = false;
+                    }
+                }
+                break;
+            case 7:
+                for ( int note = 0; note < 128; ++note ) {
+                    if ( held[ note ]) {
+                        host.noteOff( bufferSize - 1, ( int16 ) note );
+                        held[ note ] = false;
+                    }
+                }
+                break;
+        }
+    }
+
+    double percentile( const std::vector<double>& sorted, double fraction )
+    {
+        size_t index = ( size_t ) ( fraction * ( sorted.size() - 1 ) + 0.5 );
+        return sorted[ std::min( index, sorted.size() - 1 )];
+    }
+
+    Result run( int32 bufferSize, const Options& options )
+    {
+        OfflineHost host( SAMPLE_RATE, bufferSize, options.doublePrecision );
+        std::mt19937 random( options.seed );
+        bool held[ 128 ] = {};
+
+        host.setParameter( kReleaseId, 0, 0.3 );
+
+        int blocks = std::max( 1, ( int ) ( options.seconds * SAMPLE_RATE / bufferSize ));
+        std::vector<double> times;
+        times.reserve( blocks );
+
+        for ( int block = -WARMUP_BLOCKS; block < blocks; ++block )
+        {
+            schedule( host, held, block + WARMUP_BLOCKS, bufferSize, options.eventsPerBlock, random );
+
+            auto start = std::chrono::steady_clock::now();
+            host.process( bufferSize );
+            double us = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count();
+
+            if ( block >= 0 ) {
+                times.push_back( us );
+            }
+        }
+
+        Result result = {};
+        result.bufferSize = bufferSize;
+        result.blocks     = blocks;
+        result.deadline   = bufferSize / SAMPLE_RATE * 1e6;
+
+        for ( double us : times ) {
+            double load = us / result.deadline * 100.0;
+            int bucket  = 0;
+            while ( bucket < BUCKET_AMOUNT - 1 && load > BUCKETS[ bucket ]) {
+                ++bucket;
+            }
+            ++result.histogram[ bucket ];
+
+            if ( us > result.deadline ) {
+                ++result.misses;
+            }
+        }
+        std::sort( times.begin(), times.end());
+
+        result.p50  = percentile( times, 0.5 );
+        result.p99  = percentile( times, 0.99 );
+        result.p999 = percentile( times, 0.999 );
+        result.max  = times.back();
+
+        return result;
+    }
+
+    void print( const Result& result )
+    {
+        auto relative = [ &result ]( double us ) { return us / result.deadline * 100.0; };
+
+        fprintf( stderr, "buffer:%-5d deadline %8.1f us | p50 %8.1f us (%5.1f%%) | p99 %8.1f us (%5.1f%%) | "
+                         "p99.9 %8.1f us (%5.1f%%) | max %8.1f us (%5.1f%%) | %d of %d blocks missed the deadline\n",
+                 result.bufferSize, result.deadline, result.p50, relative( result.p50 ), result.p99, relative( result.p99 ),
+                 result.p999, relative( result.p999 ), result.max, relative( result.max ), result.misses, result.blocks );
+
+        fprintf( stderr, "  histogram (%% of deadline):" );
+        for ( int i = 0; i < BUCKET_AMOUNT; ++i ) {
+            if ( i < BUCKET_AMOUNT - 1 ) {
+                fprintf( stderr, " <=%g: %d", BUCKETS[ i ], result.histogram[ i ]);
+            } else {
+                fprintf( stderr, " >%g: %d\n", BUCKETS[ i - 1 ], result.histogram[ i ]);
+            }
+        }
+    }
+
+    bool writeResults( const std::vector<Result>& results, const Options& options )
+    {
+        FILE* file = options.outputPath.empty() ? stdout : fopen( options.outputPath.c_str(), "w" );
+
+        if ( file == nullptr ) {
+            return false;
+        }
+
+        fprintf( file, "{\n  \"eventsPerBlock\": %d,\n  \"precision\": \"%s\",\n  \"results\": [\n",
+                 options.eventsPerBlock, options.doublePrecision ? "double" : "float" );
+
+        for ( size_t i = 0; i < results.size(); ++i ) {
+            const Result& result = results[ i ];
+            fprintf( file, "    { \"bufferSize\": %d, \"blocks\": %d, \"deadlineUs\": %.2f, \"p50Us\": %.2f, \"p99Us\": %.2f, "
+                           "\"p999Us\": %.2f, \"maxUs\": %.2f, \"deadlineMisses\": %d, \"histogram\": [",
+                     result.bufferSize, result.blocks, result.deadline, result.p50, result.p99, result.p999, result.max, result.misses );
+            for ( int j = 0; j < BUCKET_AMOUNT; ++j ) {
+                fprintf( file, "%s%d", j > 0 ? ", " : "", result.histogram[ j ]);
+            }
+            fprintf( file, "] }%s\n", i + 1 < results.size() ? "," : "" );
+        }
+        fprintf( file, "  ]\n}\n" );
+
+        if ( file != stdout ) {
+            fclose( file );
+        }
+        return true;
+    }
+
+    void printUsage( const char* executable )
+    {
+        fprintf( stderr,
+            "Usage: %s [options]\n\n"
+            "  --output FILE       write JSON results to FILE (default stdout)\n"
+            "  --buffer-size SIZE  only run given buffer size (default runs 32 to 1024)\n"
+            "  --events AMOUNT     note events per block during bursts (default 200)\n"
+            "  --seconds SECONDS   duration of audio rendered per buffer size (default 10)\n"
+            "  --seed SEED         random seed for the storm (default 1)\n"
+            "  --double            process in double precision\n",
+            executable
+        );
+    }
+
+    bool parseOptions( int argc, char** argv, Options& options )
+    {
+        for ( int i = 1; i < argc; ++i )
+        {
+            std::string arg = argv[ i ];
+            bool hasValue   = i + 1 < argc;
+
+            if ( arg == "--output" && hasValue ) {
+                options.outputPath = argv[ ++i ];
+            } else if ( arg == "--buffer-size" && hasValue ) {
+                options.bufferSize = atoi( argv[ ++i ]);
+            } else if ( arg == "--events" && hasValue ) {
+                options.eventsPerBlock = atoi( argv[ ++i ]);
+            } else if ( arg == "--seconds" && hasValue ) {
+                options.seconds = atof( argv[ ++i ]);
+            } else if ( arg == "--seed" && hasValue ) {
+                options.seed = ( unsigned int ) atoi( argv[ ++i ]);
+            } else if ( arg == "--double" ) {
+                options.doublePrecision = true;
+            } else {
+                fprintf( stderr, "Unknown or incomplete argument: %s\n\n", arg.c_str());
+                return false;
+            }
+        }
+        return options.bufferSize >= 0 && options.eventsPerBlock >= 0 && options.seconds > 0;
+    }
+}
+
+int main( int argc, char** argv )
+{
+    Options options;
+
+    if ( !parseOptions( argc, argv, options )) {
+        printUsage( argv[ 0 ]);
+        return 1;
+    }
+
+    std::vector<Result> results;
+
+    for ( int bufferSize : BUFFER_SIZES ) {
+        if ( options.bufferSize == 0 || options.bufferSize == bufferSize ) {
+            results.push_back( run( bufferSize, options ));
+            print( results.back());
+        }
+    }
+    if ( options.bufferSize > 0 && results.empty()) {
+        results.push_back( run( options.bufferSize, options ));
+        print( results.back());
+    }
+
+    if ( !writeResults( results, options )) {
+        fprintf( stderr, "Could not write results to %s\n", options.outputPath.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "wavereader.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace Igorski {
+
+namespace {
+
+    uint32_t readUint32( const unsigned char* data )
+    {
+        return data[ 0 ] | ( data[ 1 ] << 8 ) | ( data[ 2 ] << 16 ) | (( uint32_t ) data[ 3 ] << 24 );
+    }
+
+    uint16_t readUint16( const unsigned char* data )
+    {
+        return data[ 0 ] | ( data[ 1 ] << 8 );
+    }
+}
+
+bool WaveReader::load( const char* path )
+{
+    std::ifstream file( path, std::ios::binary );
+
+    if ( !file.good()) {
+        return false;
+    }
+    std::vector<unsigned char> data(( std::istreambuf_iterator<char>( file )), std::istreambuf_iterator<char>());
+
+    if ( data.size() < 12 || memcmp( &data[ 0 ], "RIFF", 4 ) != 0 || memcmp( &data[ 8 ], "WAVE", 4 ) != 0 ) {
+        return false;
+    }
+
+    int format = 0, numChannels = 0, bitsPerSample = 0;
+    size_t offset = 12;
+
+    while ( offset + 8 <= data.size())
+    {
+        uint32_t chunkSize = readUint32( &data[ offset + 4 ]);
+        const unsigned char* chunk = &data[ offset + 8 ];
+
+        if ( offset + 8 + chunkSize > data.size()) {
+            return false;
+        }
+
+        if ( memcmp( &data[ offset ], "fmt ", 4 ) == 0 && chunkSize >= 16 ) {
+            format        = readUint16( chunk );
+            numChannels   = readUint16( chunk + 2 );
+            sampleRate    = ( int ) readUint32( chunk + 4 );
+            bitsPerSample = readUint16( chunk + 14 );
+        }
+        else if ( memcmp( &data[ offset ], "data", 4 ) == 0 )
+        {
+            bool isFloat = format == 3 && bitsPerSample == 32;
+            bool isPCM   = format == 1 && bitsPerSample == 16;
+
+            if ( numChannels == 0 || ( !isFloat && !isPCM )) {
+                return false;
+            }
+            int bytesPerSample = bitsPerSample / 8;
+            size_t numFrames   = chunkSize / ( bytesPerSample * numChannels );
+
+            channels.assign( numChannels, std::vector<float>( numFrames ));
+
+            for ( size_t i = 0; i < numFrames; ++i ) {
+                for ( int c = 0; c < numChannels; ++c ) {
+                    const unsigned char* sample = chunk + ( i * numChannels + c ) * bytesPerSample;
+                    if ( isFloat ) {
+                        uint32_t bits = readUint32( sample );
+                        memcpy( &channels[ c ][ i ], &bits, sizeof( float ));
+                    } else {
+                        channels[ c ][ i ] = ( int16_t ) readUint16( sample ) / 32767.f;
+                    }
+                }
+            }
+            return true;
+        }
+        offset += 8 + chunkSize + ( chunkSize & 1 );
+    }
+    return false;
+}
+
+} // E.O. namespace Igorski
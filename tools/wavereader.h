@@ -0,0 +1,52 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __WAVEREADER_HEADER__
+#define __WAVEREADER_HEADER__
+
+#include <string>
+#include <vector>
+
+namespace Igorski {
+
+    /**
+     * Reads RIFF WAVE files (16-bit PCM or 32-bit IEEE float)
+     * into non-interleaved single precision channel buffers
+     */
+    class WaveReader {
+
+        public:
+            bool load( const char* path );
+
+            int getSampleRate() const { return sampleRate; }
+            int getNumChannels() const { return ( int ) channels.size(); }
+            size_t getNumFrames() const { return channels.empty() ? 0 : channels[ 0 ].size(); }
+
+            const std::vector<float>& getChannel( int channel ) const { return channels[ channel ]; }
+
+        private:
+            int sampleRate = 0;
+            std::vector<std::vector<float>> channels;
+    };
+}
+
+#endif
@@ -0,0 +1,129 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "wavewriter.h"
+#include <cstring>
+
+namespace Igorski {
+
+namespace {
+
+    void writeUint32( unsigned char* out, uint32_t value )
+    {
+        out[ 0 ] = value & 0xFF;
+        out[ 1 ] = ( value >> 8 )  & 0xFF;
+        out[ 2 ] = ( value >> 16 ) & 0xFF;
+        out[ 3 ] = ( value >> 24 ) & 0xFF;
+    }
+
+    void writeUint16( unsigned char* out, uint16_t value )
+    {
+        out[ 0 ] = value & 0xFF;
+        out[ 1 ] = ( value >> 8 ) & 0xFF;
+    }
+
+    const int HEADER_SIZE = 46; // RIFF + "fmt " (18 bytes, includes cbSize) + "data" chunk headers
+}
+
+WaveWriter::WaveWriter()
+{
+    file          = nullptr;
+    numChannels   = 0;
+    bitsPerSample = 0;
+    framesWritten = 0;
+}
+
+WaveWriter::~WaveWriter()
+{
+    close();
+}
+
+bool WaveWriter::open( const char* path, int sampleRate, int channelAmount, int bits )
+{
+    close();
+
+    if ( bits != 16 && bits != 32 ) {
+        return false;
+    }
+    file = fopen( path, "wb" );
+
+    if ( file == nullptr ) {
+        return false;
+    }
+    numChannels   = channelAmount;
+    bitsPerSample = bits;
+    framesWritten = 0;
+
+    // write the header with the format description, the
+    // chunk sizes are updated once the file is closed
+
+    unsigned char header[ HEADER_SIZE ] = { 0 };
+    uint16_t blockAlign = numChannels * ( bitsPerSample / 8 );
+
+    memcpy( header, "RIFF", 4 );
+    memcpy( header + 8, "WAVE", 4 );
+    memcpy( header + 12, "fmt ", 4 );
+    writeUint32( header + 16, 18 );
+    writeUint16( header + 20, bitsPerSample == 32 ? 3 : 1 ); // IEEE float or PCM
+    writeUint16( header + 22, numChannels );
+    writeUint32( header + 24, sampleRate );
+    writeUint32( header + 28, sampleRate * blockAlign );
+    writeUint16( header + 32, blockAlign );
+    writeUint16( header + 34, bitsPerSample );
+    writeUint16( header + 36, 0 );
+    memcpy( header + 38, "data", 4 );
+
+    return fwrite( header, 1, HEADER_SIZE, file ) == HEADER_SIZE;
+}
+
+bool WaveWriter::close()
+{
+    if ( file == nullptr ) {
+        return false;
+    }
+    bool success = writeHeader();
+
+    fclose( file );
+    file = nullptr;
+
+    return success;
+}
+
+/* private methods */
+
+bool WaveWriter::writeHeader()
+{
+    uint32_t dataSize = ( uint32_t ) ( framesWritten * numChannels * ( bitsPerSample / 8 ));
+    unsigned char size[ 4 ];
+
+    writeUint32( size, HEADER_SIZE - 8 + dataSize );
+    if ( fseek( file, 4, SEEK_SET ) != 0 || fwrite( size, 1, 4, file ) != 4 ) {
+        return false;
+    }
+    writeUint32( size, dataSize );
+    if ( fseek( file, HEADER_SIZE - 4, SEEK_SET ) != 0 || fwrite( size, 1, 4, file ) != 4 ) {
+        return false;
+    }
+    return true;
+}
+
+} // E.O. namespace Igorski
@@ -0,0 +1,67 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __WAVEWRITER_HEADER__
+#define __WAVEWRITER_HEADER__
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace Igorski {
+
+    /**
+     * Streams multichannel audio into a RIFF WAVE file. Sample data is
+     * written as it comes in, the header is finalized upon close()
+     * Supported formats are 16-bit PCM and 32-bit IEEE float
+     */
+    class WaveWriter {
+
+        public:
+            WaveWriter();
+            ~WaveWriter();
+
+            bool open( const char* path, int sampleRate, int numChannels, int bitsPerSample );
+
+            // write given amount of sample frames from the non-interleaved channel buffers
+            template <typename SampleType>
+            bool write( SampleType** channelBuffers, int numFrames );
+
+            // updates the header sizes and closes the file
+            bool close();
+
+            uint64_t getFramesWritten() const { return framesWritten; }
+
+        private:
+            FILE* file;
+            int numChannels;
+            int bitsPerSample;
+            uint64_t framesWritten;
+            std::vector<unsigned char> writeBuffer;
+
+            bool writeHeader();
+    };
+}
+
+#include "wavewriter.tcc"
+
+#endif
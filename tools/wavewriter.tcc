@@ -0,0 +1,70 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <cstring>
+
+namespace Igorski {
+
+template <typename SampleType>
+bool WaveWriter::write( SampleType** channelBuffers, int numFrames )
+{
+    if ( file == nullptr ) {
+        return false;
+    }
+    int bytesPerSample = bitsPerSample / 8;
+    size_t size = ( size_t ) numFrames * numChannels * bytesPerSample;
+
+    if ( writeBuffer.size() < size ) {
+        writeBuffer.resize( size );
+    }
+    unsigned char* out = writeBuffer.data();
+
+    // interleave the channels, WAVE data is little endian
+
+    for ( int i = 0; i < numFrames; ++i )
+    {
+        for ( int c = 0; c < numChannels; ++c )
+        {
+            float sample = ( float ) channelBuffers[ c ][ i ];
+
+            if ( bitsPerSample == 16 ) {
+                int16_t pcm = ( int16_t ) ( std::max( -1.f, std::min( sample, 1.f )) * 32767.f );
+                out[ 0 ] = pcm & 0xFF;
+                out[ 1 ] = ( pcm >> 8 ) & 0xFF;
+            } else {
+                uint32_t bits;
+                memcpy( &bits, &sample, sizeof( float ));
+                out[ 0 ] = bits & 0xFF;
+                out[ 1 ] = ( bits >> 8 ) & 0xFF;
+                out[ 2 ] = ( bits >> 16 ) & 0xFF;
+                out[ 3 ] = ( bits >> 24 ) & 0xFF;
+            }
+            out += bytesPerSample;
+        }
+    }
+    framesWritten += numFrames;
+
+    return fwrite( writeBuffer.data(), 1, size, file ) == size;
+}
+
+} // E.O. namespace Igorski